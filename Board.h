@@ -0,0 +1,263 @@
+#ifndef BOARD_H
+#define BOARD_H
+//=================================================================================================================================//
+// needed header files
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+//=================================================================================================================================//
+
+// namespace to contain specific assets used during gameplay
+namespace tetris
+{
+	// the smallest unsigned integer that holds a row of a matrix some columns wide, with its two borders: 16 bits
+	// for the game's 10 columns, 32 for 16, 64 for 32 and 128 for 64
+	template <int Width>
+	struct RowBits {
+		static_assert(Width > 0,"a matrix needs a column");
+#if defined(__SIZEOF_INT128__)
+		static_assert(Width+2 <= 128,"a row is kept in at most 128 bits");
+		__extension__ typedef unsigned __int128 Widest;
+#else
+		static_assert(Width+2 <= 64,"a row is kept in at most 64 bits without 128 bit integers");
+		typedef std::uint64_t Widest;
+#endif
+		typedef typename std::conditional<(Width+2 <= 16),std::uint16_t,
+		        typename std::conditional<(Width+2 <= 32),std::uint32_t,
+		        typename std::conditional<(Width+2 <= 64),std::uint64_t,Widest>::type>::type>::type type;
+	};
+
+	// how many zero bits there are under the lowest set bit of a word that has one
+	inline int lowestBit(const std::uint32_t& word) {
+#if defined(__GNUC__)||defined(__clang__)
+		return __builtin_ctz(word);
+#else
+		int n = 0;
+		while (((word >> n) & 1u) == 0) ++n;
+		return n;
+#endif
+	}
+	inline int lowestBit(const std::uint64_t& word) {
+#if defined(__GNUC__)||defined(__clang__)
+		return __builtin_ctzll(word);
+#else
+		int n = 0;
+		while (((word >> n) & 1u) == 0) ++n;
+		return n;
+#endif
+	}
+
+	// which bit is the highest set bit of a word that has one
+	inline int highestBit(const std::uint32_t& word) {
+#if defined(__GNUC__)||defined(__clang__)
+		return 31-__builtin_clz(word);
+#else
+		int n = 31;
+		while (((word >> n) & 1u) == 0) --n;
+		return n;
+#endif
+	}
+
+	// how many bits of a word are set
+	inline int bitCount(std::uint32_t word) {
+#if defined(__GNUC__)||defined(__clang__)
+		return __builtin_popcount(word);
+#else
+		int n = 0;
+		for (; word != 0; word &= word-1) ++n;
+		return n;
+#endif
+	}
+
+	// a matrix stored as one bitmask per row, with the borders built into every mask. The game plays on a
+	// Board, 10 columns by 20 rows; other sizes are for tools that put the engine through bigger matrices
+	template <int Width,int Height>
+	class BasicBoard
+	{
+		public:
+		    typedef typename RowBits<Width>::type Row;
+
+		    // size of the matrix, not counting the borders
+		    static constexpr int width = Width, height = Height;
+		    static_assert(Height > 0,"a matrix needs a row");
+
+		    // a row with only the side borders set and a row with every bit set
+		    static constexpr Row emptyRow = Row(Row(1u) | (Row(1u) << (width+1)));
+		    static constexpr Row fullRow = Row(Row(~Row(0)) >> (8*sizeof(Row)-(width+2)));
+
+		    // a column mask is kept in one word while the rows and the bottom border fit in 32 or 64 bits, and in as
+		    // many 64 bit words as they need after that
+		    typedef typename std::conditional<(height+1 <= 32),std::uint32_t,std::uint64_t>::type Word;
+		    static constexpr int wordBits = 8*sizeof(Word), words = (height+1+wordBits-1)/wordBits;
+
+		private:
+		    // rows[0] is the top border and rows[height+1] is the bottom border. in every row
+		    // bit 0 is the left border and bit width+1 is the right border
+		    Row rows[height+2];
+		    // the same cells stored as one bitmask per column, bit r being row r of the matrix and bit height the
+		    // bottom border, so the empty cells under a block can be counted at once
+		    Word columns[width][words];
+		    // what every taken cell was filled with (the game stores the kind of tetromino), so the
+		    // matrix can be drawn from the board
+		    std::uint8_t kinds[height][width];
+		    // no row above this one has a block on it (height when the matrix is empty). Searches, clears and
+		    // garbage start from it, so on a tall matrix they cost as much as the blocks are high, not the matrix
+		    int surface;
+
+		    // the word of a column mask a row is in, and its bit in that word
+		    static constexpr int wordOf(const int& row) { return (words == 1) ? 0 : row/wordBits; }
+		    static constexpr Word bitOf(const int& row) { return Word(Word(1u) << ((words == 1) ? row : row%wordBits)); }
+
+		    // removes a row from every column mask, moving the bits of the rows above it up by one (down the matrix)
+		    void removeFromColumns(const int& row) {
+		    	Word removed = bitOf(row),above = Word(removed-1);
+		    	if constexpr (words == 1) {
+		    		for (int c = 0; c < width; ++c) columns[c][0] = Word(((columns[c][0] & above) << 1) | (columns[c][0] & ~(above | removed)));
+		    	} else {
+		    		// the top bit of every word carries into the word under it, from the surface's word down
+		    		int w = wordOf(row),top = wordOf(surface);
+		    		for (int c = 0; c < width; ++c) {
+		    			Word* column = columns[c];
+		    			column[w] = ((column[w] & above) << 1) | (column[w] & ~(above | removed)) | ((w > top) ? column[w-1] >> (wordBits-1) : 0);
+		    			for (int i = w-1; i >= top; --i) column[i] = (column[i] << 1) | ((i > top) ? column[i-1] >> (wordBits-1) : 0);
+		    		}
+		    	}
+		    }
+
+		public:
+		    BasicBoard() { reset(); } /* constructor */
+
+		    // empties the matrix and rebuilds the borders
+		    void reset() {
+		    	rows[0] = rows[height+1] = fullRow;
+		    	for (int r = 1; r <= height; ++r) rows[r] = emptyRow;
+		    	std::memset(columns,0,sizeof(columns));
+		    	for (int c = 0; c < width; ++c) columns[c][wordOf(height)] = bitOf(height);
+		    	std::memset(kinds,0,sizeof(kinds));
+		    	surface = height;
+		    }
+
+		    // the bit a column of the matrix is stored in (column -1 and column width are the borders)
+		    static constexpr Row bit(const int& column) { return Row(Row(1u) << (column+1)); }
+
+		    // is a cell taken? rows -1 and height, and columns -1 and width, are the borders. Anything
+		    // beyond the borders is off the matrix and never taken
+		    inline bool occupied(const int& row,const int& column) const {
+		    	if (row < -1 || row > height || column < -1 || column > width) return false;
+		    	return (rows[row+1] & bit(column)) != 0;
+		    }
+
+		    // does a mask built from bit() overlap anything on a row?
+		    inline bool collides(const int& row,const Row& mask) const {
+		    	if (row < -1 || row > height) return false;
+		    	return (rows[row+1] & mask) != 0;
+		    }
+
+		    // how many empty cells are right under a cell of a column, before a taken cell or the bottom border
+		    inline int depth(const int& row,const int& column) const {
+		    	if constexpr (words == 1) {
+		    		return lowestBit(Word(columns[column][0] >> (row+1)));
+		    	} else {
+		    		// every row above the surface is empty, so the search starts there at the latest
+		    		int from = (row+1 > surface) ? row+1 : surface;
+		    		int w = wordOf(from);
+		    		Word below = columns[column][w] >> (from%wordBits);
+		    		if (below != 0) return from+lowestBit(below)-row-1;
+		    		// the bottom border is always found
+		    		while (columns[column][++w] == 0) {}
+		    		return w*wordBits+lowestBit(columns[column][w])-row-1;
+		    	}
+		    }
+
+		    // has a line been formed on a row?
+		    inline bool rowIsFull(const int& row) const { return rows[row+1] == fullRow; }
+
+		    // the mask of a row, borders included
+		    inline Row getRow(const int& row) const { return rows[row+1]; }
+
+		    // a word of the mask of a column, bit r of word w being row w*wordBits+r
+		    inline Word getColumn(const int& column,const int& word = 0) const { return columns[column][word]; }
+
+		    // what a taken cell was filled with
+		    inline std::uint8_t getKind(const int& row,const int& column) const { return kinds[row][column]; }
+
+		    // no row above this one has a block on it
+		    inline int getSurface() const { return this->surface; }
+
+		    // marks a cell of the matrix as taken
+		    inline void set(const int& row,const int& column,const std::uint8_t& kind = 0) {
+		    	rows[row+1] |= bit(column); columns[column][wordOf(row)] |= bitOf(row); kinds[row][column] = kind;
+		    	if (row < surface) surface = row;
+		    }
+
+		    // removes the rows with their bit set in a mask, bit i being row first+i, in one sweep: every run of rows
+		    // kept between two removed ones moves down once, by the rows removed under it, and the top is emptied.
+		    // Only the rows from the surface down move
+		    void clearRows(const int& first,const std::uint32_t& cleared) {
+		    	if (cleared == 0) return;
+		    	if (first+lowestBit(cleared) < surface) surface = first+lowestBit(cleared);
+		    	int shift = 0,below = height;
+		    	for (std::uint32_t rest = cleared; rest != 0; ++shift) {
+		    		int i = highestBit(rest),r = first+i;
+		    		rest &= ~(std::uint32_t(1u) << i);
+		    		if (shift > 0 && below > r+1) {
+		    			std::memmove(rows+r+2+shift,rows+r+2,sizeof(Row)*(below-r-1));
+		    			std::memmove(kinds[r+1+shift],kinds[r+1],sizeof(kinds[0])*(below-r-1));
+		    		}
+		    		below = r;
+		    	}
+		    	if (below > surface) {
+		    		std::memmove(rows+surface+1+shift,rows+surface+1,sizeof(Row)*(below-surface));
+		    		std::memmove(kinds[surface+shift],kinds[surface],sizeof(kinds[0])*(below-surface));
+		    	}
+		    	for (int r = surface+1; r <= surface+shift; ++r) rows[r] = emptyRow;
+		    	std::memset(kinds[surface],0,sizeof(kinds[0])*shift);
+		    	// the top removed row first, so the rows still to go keep their bits
+		    	for (std::uint32_t rest = cleared; rest != 0; rest &= rest-1) removeFromColumns(first+lowestBit(rest));
+		    	surface += shift;
+		    }
+
+		    // pushes every row up and fills the rows freed at the bottom with garbage: rows that are full but for one
+		    // cell, in the same column on every row. Returns false if blocks were pushed off the top of the matrix
+		    bool raise(int count,const int& hole,const std::uint8_t& kind) {
+		    	if (count <= 0) return true;
+		    	if (count > height) count = height;
+		    	bool fits = true;
+		    	for (int r = surface; r < count; ++r) if (rows[r+1] != emptyRow) fits = false;
+		    	// the rows from the surface down (or those that stay on the matrix) move up, and the rest stay empty
+		    	int from = (surface > count) ? surface : count;
+		    	std::memmove(rows+1+from-count,rows+1+from,sizeof(Row)*(height-from));
+		    	std::memmove(kinds[from-count],kinds[from],sizeof(kinds[0])*(height-from));
+		    	for (int r = height-count+1; r <= height; ++r) rows[r] = Row(fullRow & ~bit(hole));
+		    	for (int r = height-count; r < height; ++r) {
+		    		for (int c = 0; c < width; ++c) kinds[r][c] = (c == hole) ? 0 : kind;
+		    	}
+		    	// in every column the bits of the rows move down by count (up the matrix) and the garbage goes under them
+		    	if constexpr (words == 1) {
+		    		Word matrix = Word((Word(1u) << height)-1),garbage = Word(matrix & ~(matrix >> count));
+		    		for (int c = 0; c < width; ++c) columns[c][0] = Word(((columns[c][0] & matrix) >> count) | (c == hole ? 0 : garbage) | bitOf(height));
+		    	} else {
+		    		// the words above the new surface's are empty before and after, so they are left alone
+		    		int skip = count/wordBits,bits = count%wordBits,top = wordOf(from-count);
+		    		for (int c = 0; c < width; ++c) {
+		    			Word* column = columns[c];
+		    			column[wordOf(height)] &= ~bitOf(height);
+		    			for (int w = top; w < words; ++w) {
+		    				Word low = (w+skip < words) ? column[w+skip] : 0,high = (w+skip+1 < words) ? column[w+skip+1] : 0;
+		    				column[w] = (bits == 0) ? low : (low >> bits) | (high << (wordBits-bits));
+		    			}
+		    			if (c != hole) for (int r = height-count; r < height; ++r) column[wordOf(r)] |= bitOf(r);
+		    			column[wordOf(height)] |= bitOf(height);
+		    		}
+		    	}
+		    	surface = from-count;
+		    	return fits;
+		    }
+	};
+
+	// the matrix the game is played on
+	typedef BasicBoard<10,20> Board;
+
+} /* end of namespace tetris */
+//=================================================================================================================================//
+#endif
@@ -0,0 +1,140 @@
+#ifndef BOT_H
+#define BOT_H
+//=================================================================================================================================//
+// needed header files
+#include <cstdint>
+#include <string>
+#include "GameEngine.h"
+#include "FeatureBatch.h"
+//=================================================================================================================================//
+
+// namespace to contain specific assets used during gameplay
+namespace tetris
+{
+	// what a bot looks at on a matrix
+	struct Features {
+		int height;    // the heights of all columns added up
+		int holes;     // empty cells with a taken cell somewhere above them
+		int bumpiness; // how much the heights of neighbouring columns differ, added up
+		int wells;     // empty cells above their column with both neighbours taken
+		int transitions; // changes between taken and empty along every row, borders included
+		int lines;     // lines cleared by the placement that led to the matrix
+	};
+
+	// how much a bot cares about each feature. Higher scores are better, so features to avoid weigh less than 0
+	struct Weights {
+		double height = -0.510066;
+		double holes = -0.35663;
+		double bumpiness = -0.184483;
+		double lines = 0.760666;
+		double wells = 0;
+		double transitions = 0;
+	};
+
+	// the features of one matrix of a measured batch, after a placement that cleared a number of lines
+	inline Features featuresOf(const FeatureBatch& batch,const int& i,const int& lines) {
+		return Features{batch.height[i],batch.holes[i],batch.bumpiness[i],batch.wells[i],batch.transitions[i],lines};
+	}
+
+	// how good a matrix is for the bot
+	inline double evaluate(const Features& features,const Weights& weights) {
+		return weights.height*features.height+weights.holes*features.holes+weights.bumpiness*features.bumpiness+weights.lines*features.lines
+		      +weights.wells*features.wells+weights.transitions*features.transitions;
+	}
+
+	// where the falling tetromino can be dropped from: the number of clockwise turns and the columns moved
+	// (left if less than 0) to get there, where it lands and how good the matrix is after it lands
+	struct Placement {
+		int turns = 0,shift = 0;
+		Piece piece = Piece{Type::Undefined,State::Up,0,0};
+		double score = 0;
+	};
+
+	// plays by dropping every tetromino where it leaves the best matrix according to its weights
+	class Bot
+	{
+		private:
+		    Weights weights;
+
+		public:
+		    Bot(const Weights& weights = Weights()): weights(weights) {} /* constructor */
+
+		    // setter methods
+		    inline void setWeights(const Weights& weights) { this->weights = weights; }
+
+		    // getter methods
+		    inline const Weights& getWeights() const { return this->weights; }
+
+		    // tries every placement the falling tetromino can reach by turning, then moving sideways, then
+		    // dropping, and picks the best one. The matrices the placements leave are measured in one batch
+		    Placement choose(const GameEngine& engine) const {
+		    	TRACE_SCOPE("Bot::choose");
+		    	const Board& board = engine.getBoard();
+		    	BoardBatch batch;
+		    	Placement candidates[batchSize];
+		    	int lines[batchSize];
+
+		    	Piece piece = engine.getCurrent();
+		    	const Orientation* tried[4];
+		    	for (int turns = 0; turns < 4; ++turns) {
+		    		if (turns > 0) {
+		    			Piece turned = engine.rotated(piece);
+		    			// a tetromino that can't turn can't reach any more states
+		    			if (turned.rotation == piece.rotation) break;
+		    			piece = turned;
+		    		}
+		    		// a state shaped like one already tried lands in the same places (the square has one shape, and
+		    		// the chord and both Z blocks have two), so it is only turned through
+		    		tried[turns] = &piece.orientation();
+		    		bool seen = false;
+		    		for (int t = 0; t < turns; ++t) seen = seen || sameShape(*tried[t],*tried[turns]);
+		    		if (seen) continue;
+		    		// slide as far left as it goes, then try every column on the way right
+		    		Piece left = piece;
+		    		while (fits(board,left.moved(0,-1))) left = left.moved(0,-1);
+		    		for (Piece moved = left; fits(board,moved); moved = moved.moved(0,1)) {
+		    			Placement& candidate = candidates[batch.count];
+		    			candidate.turns = turns; candidate.shift = moved.x-piece.x;
+		    			candidate.piece = moved.moved(dropDistance(board,moved),0);
+		    			Board after = board;
+		    			place(after,candidate.piece);
+		    			lines[batch.count] = clearLines(after,candidate.piece);
+		    			batch.add(after);
+		    		}
+		    	}
+
+		    	FeatureBatch features;
+		    	measure(batch,features);
+		    	Placement best;
+		    	for (int i = 0; i < batch.count; ++i) {
+		    		candidates[i].score = evaluate(featuresOf(features,i,lines[i]),weights);
+		    		if (i == 0 || candidates[i].score > best.score) best = candidates[i];
+		    	}
+		    	return best;
+		    }
+
+		    // plays a placement straight on an engine, without going through keys
+		    void apply(GameEngine& engine,const Placement& placement) const {
+		    	for (int i = 0; i < placement.turns; ++i) engine.step(Action::Rotate);
+		    	for (int i = 0; i < placement.shift; ++i) engine.step(Action::Right);
+		    	for (int i = 0; i > placement.shift; --i) engine.step(Action::Left);
+		    	engine.step(Action::Drop);
+		    }
+
+		    // plays a game without a screen until it is over or a number of tetrominoes have landed
+		    void play(GameEngine& engine,const unsigned& pieces) const {
+		    	while (!engine.isOver() && engine.getPieces() < pieces) apply(engine,choose(engine));
+		    }
+
+		    // the keys that play a placement, as the player would type them
+		    std::string keys(const Placement& placement) const {
+		    	std::string typed(placement.turns,'5');
+		    	typed.append(placement.shift < 0 ? -placement.shift : placement.shift,placement.shift < 0 ? '4' : '6');
+		    	typed += '0';
+		    	return typed;
+		    }
+	};
+
+} /* end of namespace tetris */
+//=================================================================================================================================//
+#endif
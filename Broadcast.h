@@ -0,0 +1,363 @@
+#ifndef BROADCAST_H
+#define BROADCAST_H
+//=================================================================================================================================//
+// needed header files
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "GameEngine.h"
+#if defined(__linux__)||defined(__linux)||defined(linux)
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#define TETRIS_BROADCAST
+#endif
+//=================================================================================================================================//
+
+// namespace to contain specific assets used during gameplay
+namespace tetris
+{
+	// a game watched live by other processes on the same machine, over a Unix domain socket. A spectator is sent
+	// the whole game once (a keyframe) and from then on only what changes on it, as the game's observer is told:
+	// the tetromino moving, landing and spawning, the rows it clears and the scores. What the game prints to its
+	// own terminal is never sent, so a spectator draws the game however it likes
+	namespace spectate
+	{
+		// what a record is
+		enum class Kind : std::uint8_t {
+			Keyframe = 1, // a new picture of the game: the level (a), score (value) and lines (extra). The rows of the
+			              // matrix and the falling tetromino follow
+			Row,          // a row of the matrix (a): the kind of every cell, 4 bits a cell, columns 0 to 7 in value and
+			              // the others in extra
+			Spawned,      // a tetromino (a its type, b its rotation, value its column and row) starts falling, and the
+			              // next shape is c
+			Moved,        // the falling tetromino is somewhere else, laid out as Spawned
+			Locked,       // the falling tetromino landed where it is laid out as Spawned
+			Cleared,      // rows were cleared (a of them): a bit for every row, numbered as they were before
+			Score,        // the score (value) and lines (extra)
+			Over          // the game is over, or it was left
+		};
+
+		// every record is 12 bytes: the kind, three bytes whose meaning depends on it and two values (little endian)
+		struct Record {
+			Kind kind;
+			std::uint8_t a,b,c;
+			std::uint32_t value,extra;
+		};
+		constexpr std::size_t recordSize = 12;
+
+		inline void encode(const Record& record,std::uint8_t* out) {
+			out[0] = static_cast<std::uint8_t>(record.kind); out[1] = record.a; out[2] = record.b; out[3] = record.c;
+			for (int i = 0; i < 4; ++i) { out[4+i] = static_cast<std::uint8_t>(record.value >> (8*i)); out[8+i] = static_cast<std::uint8_t>(record.extra >> (8*i)); }
+		}
+		inline Record decode(const std::uint8_t* in) {
+			Record record{static_cast<Kind>(in[0]),in[1],in[2],in[3],0,0};
+			for (int i = 0; i < 4; ++i) { record.value |= std::uint32_t(in[4+i]) << (8*i); record.extra |= std::uint32_t(in[8+i]) << (8*i); }
+			return record;
+		}
+
+		// appends a record to what is going to be sent
+		inline void append(std::vector<std::uint8_t>& out,const Record& record) {
+			std::size_t size = out.size();
+			out.resize(size+recordSize);
+			encode(record,&out[size]);
+		}
+
+		// a tetromino as a record, and back
+		inline Record pieceRecord(const Kind& kind,const Piece& piece,const Type& next = Type::Undefined) {
+			return Record{kind,static_cast<std::uint8_t>(piece.type),static_cast<std::uint8_t>(piece.rotation),static_cast<std::uint8_t>(next),
+			              std::uint32_t(std::uint16_t(piece.x)) | (std::uint32_t(std::uint16_t(piece.y)) << 16),0};
+		}
+		inline Piece pieceOf(const Record& record) {
+			return Piece{static_cast<Type>(record.a),static_cast<State>(record.b & 3),
+			             static_cast<std::int16_t>(record.value & 0xffff),static_cast<std::int16_t>(record.value >> 16)};
+		}
+
+		// can a tetromino from a record be drawn: is it a shape that exists, with every block on the matrix?
+		inline bool onMatrix(const Piece& piece) {
+			if (piece.type == Type::Undefined || piece.type > Type::RZBlock) return false;
+			for (int i = 0; i < 4; ++i) {
+				if (piece.row(i) < 0 || piece.row(i) >= Board::height || piece.column(i) < 0 || piece.column(i) >= Board::width) return false;
+			}
+			return true;
+		}
+
+		// appends the records of a keyframe: the scores, every row of the matrix and the falling tetromino
+		inline void keyframe(std::vector<std::uint8_t>& out,const GameEngine& engine,const int& level) {
+			append(out,Record{Kind::Keyframe,static_cast<std::uint8_t>(level),0,0,engine.getScore(),engine.getLines()});
+			const Board& board = engine.getBoard();
+			for (int r = 0; r < Board::height; ++r) {
+				std::uint32_t low = 0,high = 0;
+				for (int c = 0; c < Board::width; ++c) {
+					std::uint32_t kind = board.occupied(r,c) ? (board.getKind(r,c) & 0xf) : 0;
+					if (c < 8) low |= kind << (4*c);
+					else high |= kind << (4*(c-8));
+				}
+				append(out,Record{Kind::Row,static_cast<std::uint8_t>(r),0,0,low,high});
+			}
+			append(out,pieceRecord(Kind::Spawned,engine.getCurrent(),engine.getNext()));
+		}
+
+		// the game as a spectator sees it, put together from the records it is sent. Records that come before the
+		// first keyframe are skipped, since they change a picture the spectator doesn't have
+		struct Picture {
+			Board board;
+			Piece current = Piece{Type::Undefined,State::Up,0,0};
+			Type next = Type::Undefined;
+			unsigned score = 0,lines = 0;
+			int level = 0;
+			bool synced = false,over = false;
+
+			// applies a record. Returns false for a record this version doesn't know, or one that can't be right (a
+			// row, cell kind or tetromino that doesn't exist): the stream is corrupt or out of step, so nothing of
+			// it is applied and the picture stops being synced until the spectator is sent a new keyframe
+			bool apply(const Record& record) {
+				if (record.kind == Kind::Keyframe) {
+					board.reset(); level = record.a; score = record.value; lines = record.extra;
+					current = Piece{Type::Undefined,State::Up,0,0}; next = Type::Undefined;
+					synced = true; over = false;
+					return true;
+				}
+				if (!synced) return record.kind > Kind::Keyframe && record.kind <= Kind::Over;
+				if (!valid(record)) { synced = false; return false; }
+				switch (record.kind) {
+					case Kind::Row:
+						for (int c = 0; c < Board::width; ++c) {
+							std::uint8_t kind = cellOf(record,c);
+							if (kind != 0) board.set(record.a,c,kind);
+						}
+						break;
+					case Kind::Spawned: current = pieceOf(record); next = static_cast<Type>(record.c); break;
+					case Kind::Moved: current = pieceOf(record); break;
+					case Kind::Locked: current = pieceOf(record); place(board,current); break;
+					case Kind::Cleared: board.clearRows(0,record.value & ((std::uint32_t(1u) << Board::height)-1)); break;
+					case Kind::Score: score = record.value; lines = record.extra; break;
+					case Kind::Over: over = true; break;
+					default: break;
+				}
+				return true;
+			}
+
+			// the kind of a cell of a Row record
+			static inline std::uint8_t cellOf(const Record& record,const int& column) {
+				return static_cast<std::uint8_t>(((column < 8) ? record.value >> (4*column) : record.extra >> (4*(column-8))) & 0xf);
+			}
+
+			// could a record have come from a game? The kinds of the cells of a row go up to the garbage's, and
+			// tetrominoes and the next shape are shapes that exist, on the matrix
+			static bool valid(const Record& record) {
+				switch (record.kind) {
+					case Kind::Row:
+						if (record.a >= Board::height) return false;
+						for (int c = 0; c < Board::width; ++c) if (cellOf(record,c) > garbageKind) return false;
+						return true;
+					case Kind::Spawned: return onMatrix(pieceOf(record)) && record.c <= static_cast<std::uint8_t>(Type::RZBlock);
+					case Kind::Moved: case Kind::Locked: return onMatrix(pieceOf(record));
+					case Kind::Cleared: case Kind::Score: case Kind::Over: return true;
+					default: return false;
+				}
+			}
+		};
+
+	} /* end of namespace spectate */
+
+#ifdef TETRIS_BROADCAST
+	// sends the game being played to every spectator connected to a socket. It watches the game in front of the
+	// view that draws it, and passes everything it is told on to that view. Records are kept until flush(),
+	// which sends them to every spectator with one write each, after the player's frame is out. Nothing ever
+	// waits on a spectator: one that can't take a write keeps the rest, and once it falls more than maxPending
+	// bytes behind, what it is owed is thrown away for a new keyframe. A spectator that falls that far behind
+	// again before it has taken the keyframe is let go
+	class Broadcast : public GameObserver
+	{
+		public:
+		    // the most bytes a spectator can owe before it is sent a keyframe instead
+		    static constexpr std::size_t maxPending = 1 << 16;
+
+		private:
+		    // a watcher: its socket, the bytes it is owed, how far into a record the socket is and whether it is
+		    // catching up on a keyframe
+		    struct Spectator {
+		    	int fd;
+		    	std::vector<std::uint8_t> pending;
+		    	std::size_t offset;
+		    	bool resyncing;
+		    };
+
+		    int listener = -1;
+		    std::string path;
+		    std::vector<Spectator> spectators;
+		    // the records since the last flush, and a keyframe being put together
+		    std::vector<std::uint8_t> tick,frame;
+		    // the game being played (none between games) and its level
+		    const GameEngine* engine = nullptr;
+		    int level = 0;
+		    // the view drawing the game
+		    GameObserver* next = nullptr;
+		    unsigned dropped = 0,resynced = 0;
+		    // the rows the tetromino that just landed filled
+		    std::uint32_t clearing = 0;
+
+		    // writes as much as the socket takes. Returns how many bytes it took, or -1 if the spectator is gone
+		    static long write(const int& fd,const std::uint8_t* data,const std::size_t& size) {
+		    	std::size_t sent = 0;
+		    	while (sent < size) {
+		    		ssize_t n = ::send(fd,data+sent,size-sent,MSG_DONTWAIT | MSG_NOSIGNAL);
+		    		if (n > 0) { sent += n; continue; }
+		    		if (n < 0 && errno == EINTR) continue;
+		    		if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+		    		return -1;
+		    	}
+		    	return static_cast<long>(sent);
+		    }
+
+		    // sends bytes to a spectator after what it already owes. Returns false if it has to be let go
+		    bool deliver(Spectator& spectator,const std::uint8_t* data,const std::size_t& size) {
+		    	if (spectator.pending.empty()) {
+		    		long n = write(spectator.fd,data,size);
+		    		if (n < 0) return false;
+		    		spectator.offset = (spectator.offset+n)%spectate::recordSize;
+		    		spectator.pending.insert(spectator.pending.end(),data+n,data+size);
+		    	} else {
+		    		spectator.pending.insert(spectator.pending.end(),data,data+size);
+		    		long n = write(spectator.fd,spectator.pending.data(),spectator.pending.size());
+		    		if (n < 0) return false;
+		    		spectator.offset = (spectator.offset+n)%spectate::recordSize;
+		    		spectator.pending.erase(spectator.pending.begin(),spectator.pending.begin()+n);
+		    	}
+		    	if (spectator.pending.empty()) spectator.resyncing = false;
+		    	if (spectator.pending.size() <= maxPending) return true;
+		    	if (spectator.resyncing || engine == nullptr) return false;
+
+		    	// keep the rest of the record the socket is in the middle of, so the stream stays whole
+		    	spectator.pending.resize(spectator.offset == 0 ? 0 : spectate::recordSize-spectator.offset);
+		    	frame.clear(); spectate::keyframe(frame,*engine,level);
+		    	spectator.pending.insert(spectator.pending.end(),frame.begin(),frame.end());
+		    	spectator.resyncing = true; ++resynced;
+		    	return true;
+		    }
+
+		    inline void record(const spectate::Record& record) { if (engine != nullptr) spectate::append(tick,record); }
+
+		public:
+		    Broadcast() { tick.reserve(1024); frame.reserve(1024); } /* constructor */
+		    ~Broadcast() { close(); } /* destructor */
+		    Broadcast(const Broadcast&) = delete;
+		    Broadcast& operator=(const Broadcast&) = delete;
+
+		    // getter methods
+		    inline int getFd() const { return this->listener; }
+		    inline bool isOpen() const { return this->listener >= 0; }
+		    inline std::size_t getSpectators() const { return this->spectators.size(); }
+		    inline unsigned getDropped() const { return this->dropped; }
+		    inline unsigned getResynced() const { return this->resynced; }
+
+		    // setter methods
+		    inline void setNext(GameObserver* next) { this->next = next; }
+
+		    // waits for spectators on a socket. A socket file nobody answers on was left behind by a game that
+		    // ended and is replaced. Returns false if the socket couldn't be made
+		    bool open(const std::string& path) {
+		    	close();
+		    	sockaddr_un address;
+		    	std::memset(&address,0,sizeof(address));
+		    	address.sun_family = AF_UNIX;
+		    	if (path.empty() || path.size() >= sizeof(address.sun_path)) return false;
+		    	std::memcpy(address.sun_path,path.c_str(),path.size());
+
+		    	// a game already on the socket answers, or is too busy to
+		    	int probe = socket(AF_UNIX,SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK,0);
+		    	if (probe < 0) return false;
+		    	bool taken = connect(probe,reinterpret_cast<sockaddr*>(&address),sizeof(address)) == 0;
+		    	int reason = errno;
+		    	::close(probe);
+		    	if (taken || (reason != ENOENT && reason != ECONNREFUSED)) return false;
+		    	unlink(path.c_str());
+
+		    	listener = socket(AF_UNIX,SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK,0);
+		    	if (listener < 0) return false;
+		    	if (bind(listener,reinterpret_cast<sockaddr*>(&address),sizeof(address)) != 0 || listen(listener,128) != 0) {
+		    		::close(listener); listener = -1; return false;
+		    	}
+		    	this->path = path;
+		    	return true;
+		    }
+
+		    // lets every spectator go and removes the socket file
+		    void close() {
+		    	for (Spectator& spectator : spectators) ::close(spectator.fd);
+		    	spectators.clear(); tick.clear();
+		    	if (listener >= 0) { ::close(listener); unlink(path.c_str()); }
+		    	listener = -1; engine = nullptr;
+		    }
+
+		    // takes every spectator waiting to connect. Each is sent a keyframe of the game being played, if one is
+		    void accept() {
+		    	if (listener < 0) return;
+		    	// a new spectator's keyframe already has the records not sent yet in it
+		    	flush();
+		    	if (engine != nullptr) { frame.clear(); spectate::keyframe(frame,*engine,level); }
+		    	int fd;
+		    	while ((fd = accept4(listener,nullptr,nullptr,SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0 || errno == EINTR) {
+		    		if (fd < 0) continue;
+		    		spectators.push_back(Spectator{fd,std::vector<std::uint8_t>(),0,false});
+		    		if (engine != nullptr && !deliver(spectators.back(),frame.data(),frame.size())) { ::close(fd); spectators.pop_back(); ++dropped; }
+		    	}
+		    }
+
+		    // a game starts: every spectator is sent a keyframe of it with the next flush
+		    void start(const GameEngine& engine,const int& level) {
+		    	this->engine = &engine; this->level = level;
+		    	tick.clear(); spectate::keyframe(tick,engine,level);
+		    }
+
+		    // the game ends, or is left
+		    void finish() {
+		    	if (engine != nullptr && !engine->isOver()) record(spectate::Record{spectate::Kind::Over,0,0,0,0,0});
+		    	flush();
+		    	engine = nullptr;
+		    }
+
+		    // sends the records since the last flush to every spectator
+		    void flush() {
+		    	if (tick.empty()) return;
+		    	for (std::size_t i = 0; i < spectators.size(); ) {
+		    		if (deliver(spectators[i],tick.data(),tick.size())) { ++i; continue; }
+		    		::close(spectators[i].fd); ++dropped;
+		    		spectators[i] = std::move(spectators.back()); spectators.pop_back();
+		    	}
+		    	tick.clear();
+		    }
+
+		    void pieceMoved(const GameEngine& engine) {
+		    	record(spectate::pieceRecord(spectate::Kind::Moved,engine.getCurrent()));
+		    	if (next != nullptr) next->pieceMoved(engine);
+		    }
+		    // the rows about to be cleared are the full ones the tetromino landed on, kept for linesCleared()
+		    void pieceLocked(const GameEngine& engine) {
+		    	clearing = fullRows(engine.getBoard(),engine.getCurrent()) << engine.getCurrent().top();
+		    	record(spectate::pieceRecord(spectate::Kind::Locked,engine.getCurrent()));
+		    	if (next != nullptr) next->pieceLocked(engine);
+		    }
+		    void linesCleared(const GameEngine& engine,int cleared) {
+		    	record(spectate::Record{spectate::Kind::Cleared,static_cast<std::uint8_t>(cleared),0,0,clearing,0});
+		    	record(spectate::Record{spectate::Kind::Score,0,0,0,engine.getScore(),engine.getLines()});
+		    	if (next != nullptr) next->linesCleared(engine,cleared);
+		    }
+		    void pieceSpawned(const GameEngine& engine) {
+		    	record(spectate::pieceRecord(spectate::Kind::Spawned,engine.getCurrent(),engine.getNext()));
+		    	if (next != nullptr) next->pieceSpawned(engine);
+		    }
+		    void gameOver(const GameEngine& engine) {
+		    	record(spectate::Record{spectate::Kind::Over,0,0,0,0,0});
+		    	if (next != nullptr) next->gameOver(engine);
+		    }
+	};
+#endif
+
+} /* end of namespace tetris */
+//=================================================================================================================================//
+#endif
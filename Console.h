@@ -0,0 +1,46 @@
+#ifndef CONSOLE_H
+#define CONSOLE_H
+//=================================================================================================================================//
+// needed header files
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+//=================================================================================================================================//
+
+// getch() and kbhit() for systems without conio.h. Both switch the terminal to reading keys as they are
+// pressed, without echoing them, and give the terminal back before they return
+
+// reads a key as soon as it is pressed, without showing it
+inline int getch() {
+	termios saved,settings;
+	bool raw = (tcgetattr(0,&saved) == 0);
+	if (raw) {
+		settings = saved;
+		settings.c_lflag &= ~(ICANON | ECHO);
+		settings.c_cc[VMIN] = 1; settings.c_cc[VTIME] = 0;
+		tcsetattr(0,TCSANOW,&settings);
+	}
+	char key = 0;
+	// the terminal is gone, so leave whatever is waiting for a key
+	if (read(0,&key,1) != 1) key = '#';
+	if (raw) tcsetattr(0,TCSANOW,&saved);
+	return key;
+}
+
+// has a key been pressed that hasn't been read yet?
+inline int kbhit() {
+	termios saved,settings;
+	bool raw = (tcgetattr(0,&saved) == 0);
+	if (raw) {
+		settings = saved;
+		settings.c_lflag &= ~(ICANON | ECHO);
+		tcsetattr(0,TCSANOW,&settings);
+	}
+	int waiting = 0;
+	ioctl(0,FIONREAD,&waiting);
+	if (raw) tcsetattr(0,TCSANOW,&saved);
+	return waiting > 0;
+}
+
+//=================================================================================================================================//
+#endif
@@ -0,0 +1,141 @@
+#ifndef ESCAPE_H
+#define ESCAPE_H
+//=================================================================================================================================//
+// needed header files
+#include <cstdint>
+#include <cstring>
+#include <string>
+//=================================================================================================================================//
+
+// namespace to contain all the tools the game needs
+namespace SimpleAssets
+{
+	// stores available text color
+	enum textColor {
+	    red = 31,green = 32,yellow = 33,blue = 34,pink = 35,cyan = 36, normal = 39,darkgray = 90,white = 97
+	};
+
+	// stores available background color
+	enum bcgColor {
+	    Black = 40, Red = 41,Green = 42,Yellow = 43,Blue = 44,Pink = 45,Cyan = 46,Normal = 49,DarkGray = 100,White = 107
+	};
+
+	// writes the escape sequences the game prints into memory the caller gives, so printing one never builds a string
+	namespace escape
+	{
+		// the longest sequence written: "\033[1;" two numbers of up to 5 digits, ';' and the final letter. Every
+		// number is kept to 5 digits, so nothing written can run past it
+		constexpr std::size_t longest = 16;
+		constexpr unsigned largest = 99999;
+		static_assert(4+5+1+5+1 <= longest,"a sequence has room for two numbers of 5 digits");
+
+		// a row, column or color kept within the numbers a sequence has room for
+		inline unsigned bounded(const int& n) { return (n < 0) ? 0u : (n > static_cast<int>(largest)) ? largest : static_cast<unsigned>(n); }
+
+		// the two digits of every number below 100, so a number is written two digits at a time
+		constexpr char digitPairs[201] =
+			"00010203040506070809101112131415161718192021222324"
+			"25262728293031323334353637383940414243444546474849"
+			"50515253545556575859606162636465666768697071727374"
+			"75767778798081828384858687888990919293949596979899";
+
+		// writes a number in decimal, largest at most, and returns where it ends
+		inline char* writeNumber(char* out,unsigned n) {
+			if (n > largest) n = largest;
+			if (n < 10) { *out = char('0'+n); return out+1; }
+			if (n < 100) { std::memcpy(out,digitPairs+2*n,2); return out+2; }
+			// numbers this big are rare: write them backwards into a scratch space first
+			char digits[10]; char* end = digits+sizeof(digits); char* p = end;
+			for (; n >= 100; n /= 100) { p -= 2; std::memcpy(p,digitPairs+2*(n%100),2); }
+			if (n < 10) *--p = char('0'+n);
+			else { p -= 2; std::memcpy(p,digitPairs+2*n,2); }
+			std::memcpy(out,p,end-p);
+			return out+(end-p);
+		}
+
+		// writes the sequences that move the cursor and set the color, returning where they end. Both need room
+		// for longest characters
+		inline char* writeCursor(char* out,const int& row,const int& column) {
+			*out++ = '\033'; *out++ = '[';
+			out = writeNumber(out,bounded(row)); *out++ = ';';
+			out = writeNumber(out,bounded(column)); *out++ = 'H';
+			return out;
+		}
+		inline char* writeColor(char* out,const int& fg,const int& bg) {
+			std::memcpy(out,"\033[1;",4); out += 4;
+			out = writeNumber(out,bounded(fg)); *out++ = ';';
+			out = writeNumber(out,bounded(bg)); *out++ = 'm';
+			return out;
+		}
+
+	} /* end of namespace escape */
+
+	// an escape sequence kept by value, which cursor() and color() return instead of a string
+	struct Sequence {
+		char bytes[escape::longest] = {};
+		std::uint8_t size = 0;
+
+		inline const char* data() const { return bytes; }
+		inline std::size_t length() const { return size; }
+		inline operator std::string() const { return std::string(bytes,size); }
+	};
+
+	namespace escape
+	{
+		// the color sequence of every text and background color, worked out when the game is compiled
+		constexpr int textColors[9] = {red,green,yellow,blue,pink,cyan,normal,darkgray,white};
+		constexpr int bcgColors[10] = {Black,Red,Green,Yellow,Blue,Pink,Cyan,Normal,DarkGray,White};
+
+		// color codes have 3 digits at most
+		constexpr Sequence makeColor(int fg,int bg) {
+			fg = (fg < 0) ? 0 : (fg > 999) ? 999 : fg; bg = (bg < 0) ? 0 : (bg > 999) ? 999 : bg;
+			Sequence n;
+			const char start[4] = {'\033','[','1',';'};
+			for (char c : start) n.bytes[n.size++] = c;
+			if (fg >= 100) n.bytes[n.size++] = char('0'+fg/100);
+			n.bytes[n.size++] = char('0'+fg/10%10); n.bytes[n.size++] = char('0'+fg%10); n.bytes[n.size++] = ';';
+			if (bg >= 100) n.bytes[n.size++] = char('0'+bg/100);
+			n.bytes[n.size++] = char('0'+bg/10%10); n.bytes[n.size++] = char('0'+bg%10); n.bytes[n.size++] = 'm';
+			return n;
+		}
+
+		struct ColorTable {
+			Sequence sequences[9][10];
+			constexpr ColorTable(): sequences() {
+				for (int t = 0; t < 9; ++t) for (int b = 0; b < 10; ++b) sequences[t][b] = makeColor(textColors[t],bcgColors[b]);
+			}
+		};
+		constexpr ColorTable colors;
+
+		// where a color is in the table, or -1 for a code that isn't one of the colors
+		constexpr int indexOf(const int* codes,const int& count,const int& code) {
+			for (int i = 0; i < count; ++i) if (codes[i] == code) return i;
+			return -1;
+		}
+
+	} /* end of namespace escape */
+
+	// sets cursor position
+	inline Sequence cursor(const int& row = 35, const int& column = 1) {
+		Sequence n;
+		n.size = static_cast<std::uint8_t>(escape::writeCursor(n.bytes,row,column)-n.bytes);
+		return n;
+	}
+
+	// sets text and background color
+	constexpr Sequence color(const textColor& c = normal,const bcgColor& b = Normal) {
+		int t = escape::indexOf(escape::textColors,9,c),g = escape::indexOf(escape::bcgColors,10,b);
+		return (t >= 0 && g >= 0) ? escape::colors.sequences[t][g] : escape::makeColor(c,b);
+	}
+
+	// joins a sequence with text
+	inline std::string& operator+=(std::string& n,const Sequence& s) { return n.append(s.data(),s.length()); }
+	inline std::string operator+(std::string n,const Sequence& s) { return n += s; }
+	inline std::string operator+(const char* n,const Sequence& s) { return std::string(n)+s; }
+	inline std::string operator+(const Sequence& s,const std::string& n) { return std::string(s).append(n); }
+	inline std::string operator+(const Sequence& s,const char* n) { return std::string(s).append(n); }
+	inline std::string operator+(const Sequence& s,const Sequence& t) { return std::string(s)+t; }
+
+} /* end of namespace SimpleAssets */
+//=================================================================================================================================//
+#endif
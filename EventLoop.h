@@ -0,0 +1,259 @@
+#ifndef EVENT_LOOP_H
+#define EVENT_LOOP_H
+//=================================================================================================================================//
+// needed header files
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#if defined(__linux__)||defined(__linux)||defined(linux)
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#else
+#include <thread>
+#if __has_include(<conio.h>)
+#include <conio.h> /* kbhit() and getch() */
+#else
+#include "Console.h" /* getch() and kbhit() through termios */
+#endif
+#endif
+//=================================================================================================================================//
+
+// namespace to contain specific assets used during gameplay
+namespace tetris
+{
+	// what woke the game up
+	enum class Event {
+		Key,Gravity,Idle,Peer
+	};
+
+	// set once a signal asks the game to stop (Ctrl-C, kill, or the terminal closing). The handler only sets it and
+	// writes a byte to a pipe the event loop waits on, so the game leaves the way it does for # and gives the
+	// terminal back on its way out rather than being killed with the terminal left raw
+	inline volatile std::sig_atomic_t stopRequested = 0;
+	inline int stopPipe[2] = {-1,-1};
+
+	inline void requestStop(int) {
+		stopRequested = 1;
+#if defined(__linux__)||defined(__linux)||defined(linux)
+		int saved = errno;
+		if (stopPipe[1] >= 0) { ssize_t written = write(stopPipe[1],"#",1); (void)written; }
+		errno = saved;
+#endif
+	}
+
+	// makes SIGINT, SIGTERM and SIGHUP ask the game to stop. Only what plays on a terminal should call it
+	inline void catchStopSignals() {
+#if defined(__linux__)||defined(__linux)||defined(linux)
+		if (stopPipe[0] < 0 && pipe(stopPipe) == 0) {
+			for (int fd : stopPipe) { fcntl(fd,F_SETFL,fcntl(fd,F_GETFL,0) | O_NONBLOCK); fcntl(fd,F_SETFD,FD_CLOEXEC); }
+		}
+		// without SA_RESTART, so a read waiting for a key in the menu returns
+		struct sigaction action;
+		action.sa_handler = requestStop;
+		sigemptyset(&action.sa_mask);
+		action.sa_flags = 0;
+		sigaction(SIGINT,&action,nullptr); sigaction(SIGTERM,&action,nullptr); sigaction(SIGHUP,&action,nullptr);
+#else
+		std::signal(SIGINT,requestStop); std::signal(SIGTERM,requestStop);
+#endif
+	}
+
+	// sleeps until a key is pressed or the falling tetromino is due to move down a row. Gravity runs on
+	// steady_clock deadlines that move on by exactly one interval per row, so the time spent handling keys and
+	// drawing never adds up into a slower game, and rows that fall due while the game is busy are owed and
+	// handed out one by one rather than dropped. Every board of a split screen has a gravity timer of its own.
+	// On Linux keys are waited for with ppoll(), elsewhere by checking kbhit() every millisecond
+	class EventLoop
+	{
+		private:
+		    typedef std::chrono::steady_clock Clock;
+
+		    // the most rows gravity owes. A longer stall than this (a suspended terminal) isn't made up for
+		    static constexpr unsigned maxBacklog = 32;
+
+		public:
+		    // the most gravity timers, one for every board on the screen
+		    static constexpr int maxTimers = 8;
+
+		private:
+
+		    // the key that woke the loop up
+		    char key = '\0';
+		    // when the last key woke the loop up
+		    Clock::time_point woken;
+		    // microseconds between a key waking the loop up and its handler finishing
+		    unsigned lastLatency = 0,maxLatency = 0;
+
+		    // when gravity is next due, how often it is due (zero while it is stopped), and the rows it is owed
+		    // that haven't been handed out
+		    struct Timer {
+		    	Clock::time_point due;
+		    	Clock::duration interval = Clock::duration::zero();
+		    	unsigned backlog = 0;
+		    };
+		    Timer timers[maxTimers];
+		    // the timer of the last row handed out, and the rows owed by all the timers
+		    int timer = 0;
+		    unsigned backlog = 0;
+#if defined(__linux__)||defined(__linux)||defined(linux)
+		    // where keys are read from and the terminal settings to restore when the game ends
+		    int input = 0;
+		    // a socket an opponent's messages or spectators arrive on, -1 if there isn't one
+		    int peer = -1;
+		    termios saved;
+		    bool raw = false;
+#endif
+
+		    // adds every row that has fallen due since the last call to the backlogs, and returns when the next
+		    // row is due (the end of time if no timer is running)
+		    Clock::time_point accumulate() {
+		    	Clock::time_point now = Clock::now(),next = Clock::time_point::max();
+		    	for (Timer& t : timers) {
+		    		if (t.interval == Clock::duration::zero()) continue;
+		    		if (now >= t.due) {
+		    			Clock::duration::rep rows = 1+(now-t.due)/t.interval;
+		    			t.due += rows*t.interval;
+		    			unsigned owed = (t.backlog+rows > maxBacklog) ? maxBacklog : t.backlog+static_cast<unsigned>(rows);
+		    			backlog += owed-t.backlog; t.backlog = owed;
+		    		}
+		    		if (t.due < next) next = t.due;
+		    	}
+		    	return next;
+		    }
+
+		    // hands out a row owed, taking the timers in turn so a board that is far behind can't hold up the others
+		    inline void handOut() {
+		    	for (int i = 1; i <= maxTimers; ++i) {
+		    		Timer& t = timers[(timer+i)%maxTimers];
+		    		if (t.backlog > 0) { --t.backlog; --backlog; timer = (timer+i)%maxTimers; return; }
+		    	}
+		    }
+
+		public:
+		    EventLoop() {} /* constructor */
+		    ~EventLoop() { close(); } /* destructor */
+
+		    // getter methods
+		    inline char getKey() const { return this->key; }
+		    inline unsigned getLastLatency() const { return this->lastLatency; }
+		    inline unsigned getMaxLatency() const { return this->maxLatency; }
+		    // rows gravity is owed that wait() hasn't handed out yet, by all the timers
+		    inline unsigned getBacklog() const { return this->backlog; }
+		    // the timer whose row the last Event::Gravity was
+		    inline int getTimer() const { return this->timer; }
+
+		    // prepares the terminal for a game. Keys are read from the terminal unless another file is given
+		    void open(const int& input = 0) {
+		    	lastLatency = maxLatency = 0;
+#if defined(__linux__)||defined(__linux)||defined(linux)
+		    	this->input = input;
+		    	// keys have to be readable as soon as they are pressed, without waiting for a new line
+		    	if (!raw && tcgetattr(input,&saved) == 0) {
+		    		termios settings = saved;
+		    		settings.c_lflag &= ~(ICANON | ECHO);
+		    		settings.c_cc[VMIN] = 1; settings.c_cc[VTIME] = 0;
+		    		raw = (tcsetattr(input,TCSANOW,&settings) == 0);
+		    	}
+#else
+		    	(void)input;
+#endif
+		    }
+
+#if defined(__linux__)||defined(__linux)||defined(linux)
+		    // also wakes the loop up with Event::Peer when a socket can be read, or stops if it is -1. Nothing is
+		    // read from it: that is left to whoever is watching it
+		    inline void watch(const int& fd) { this->peer = fd; }
+#endif
+
+		    // gives the terminal back and stops gravity
+		    void close() {
+		    	for (Timer& t : timers) t = Timer();
+		    	backlog = 0;
+#if defined(__linux__)||defined(__linux)||defined(linux)
+		    	peer = -1;
+		    	if (raw) { tcsetattr(input,TCSANOW,&saved); raw = false; }
+#endif
+		    }
+
+		    // (re)starts a gravity timer so that it is due every given number of milliseconds from now, forgetting
+		    // any rows it was owed
+		    void start(const unsigned& milliseconds,const int& timer = 0) {
+		    	Timer& t = timers[timer];
+		    	t.interval = std::chrono::milliseconds(milliseconds);
+		    	t.due = Clock::now()+t.interval;
+		    	backlog -= t.backlog; t.backlog = 0;
+		    }
+
+		    // stops a gravity timer, for a board whose game is over
+		    void stop(const int& timer) {
+		    	Timer& t = timers[timer];
+		    	backlog -= t.backlog; t = Timer();
+		    }
+
+		    // sleeps until a key is pressed or gravity is due, or for at most a number of milliseconds if one is
+		    // given (-1 waits for as long as it takes). A pending key is always handled first
+		    Event wait(const int& timeout = -1) {
+		    	Clock::time_point until = Clock::now()+std::chrono::milliseconds(timeout < 0 ? 0 : timeout);
+		    	while (true) {
+#if defined(__linux__)||defined(__linux)||defined(linux)
+		    		Clock::time_point due = accumulate();
+		    		bool running = (due != Clock::time_point::max());
+		    		// sleep until the earlier of the gravity deadline and the timeout, not at all if rows are owed
+		    		bool forever = (backlog == 0 && !running && timeout < 0);
+		    		Clock::time_point wake = (backlog > 0) ? Clock::now() : !running ? until
+		    		                       : (timeout < 0 || due < until) ? due : until;
+		    		std::chrono::nanoseconds left = std::chrono::duration_cast<std::chrono::nanoseconds>(wake-Clock::now());
+		    		if (left.count() < 0) left = std::chrono::nanoseconds::zero();
+		    		timespec sleep;
+		    		sleep.tv_sec = static_cast<time_t>(left.count()/1000000000); sleep.tv_nsec = static_cast<long>(left.count()%1000000000);
+		    		// the stop pipe is never emptied, so once a signal has come every wait hands out #
+		    		pollfd fds[3] = {{stopPipe[0],POLLIN,0},{input,POLLIN,0},{peer,POLLIN,0}};
+		    		int ready = ppoll(fds,(peer < 0) ? 2 : 3,forever ? nullptr : &sleep,nullptr);
+		    		if (ready < 0) continue;
+		    		if (ready > 0 && (fds[0].revents & POLLIN)) { woken = Clock::now(); key = '#'; return Event::Key; }
+		    		if (ready > 0 && (fds[1].revents & (POLLIN | POLLHUP))) {
+		    			woken = Clock::now();
+		    			if (read(input,&key,1) != 1) key = '#'; // the terminal is gone, so end the game
+		    			return Event::Key;
+		    		}
+		    		if (ready > 0 && (fds[2].revents & (POLLIN | POLLHUP | POLLERR))) return Event::Peer;
+#else
+		    		accumulate();
+		    		if (stopRequested) { woken = Clock::now(); key = '#'; return Event::Key; }
+		    		if (kbhit()) { woken = Clock::now(); key = getch(); return Event::Key; }
+#endif
+		    		accumulate();
+		    		if (backlog > 0) { handOut(); return Event::Gravity; }
+		    		if (timeout >= 0 && Clock::now() >= until) return Event::Idle;
+#if !(defined(__linux__)||defined(__linux)||defined(linux))
+		    		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+#endif
+		    	}
+		    }
+
+		    // blocks until a key is pressed, without gravity
+		    char waitForKey() {
+#if defined(__linux__)||defined(__linux)||defined(linux)
+		    	pollfd fds[2] = {{stopPipe[0],POLLIN,0},{input,POLLIN,0}};
+		    	while (poll(fds,2,-1) < 0) {}
+		    	woken = Clock::now();
+		    	if ((fds[0].revents & POLLIN) || read(input,&key,1) != 1) key = '#';
+#else
+		    	key = stopRequested ? '#' : getch(); woken = Clock::now();
+#endif
+		    	return key;
+		    }
+
+		    // called once the key that woke the loop up has been handled and drawn
+		    void handled() {
+		    	lastLatency = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now()-woken).count();
+		    	if (lastLatency > maxLatency) maxLatency = lastLatency;
+		    }
+	};
+
+} /* end of namespace tetris */
+//=================================================================================================================================//
+#endif
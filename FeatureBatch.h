@@ -0,0 +1,168 @@
+#ifndef FEATURE_BATCH_H
+#define FEATURE_BATCH_H
+//=================================================================================================================================//
+// needed header files
+#include <cstdint>
+#include "Board.h"
+#if (defined(__x86_64__)||defined(__i386__))&&(defined(__GNUC__)||defined(__clang__))
+#define TETRIS_SIMD
+#include <immintrin.h>
+#endif
+//=================================================================================================================================//
+
+// namespace to contain specific assets used during gameplay
+namespace tetris
+{
+	// the most matrices measured in one batch
+	constexpr int batchSize = 64;
+
+	// matrices to measure, stored a row at a time across the batch: rows[r][i] is row r of matrix i, borders
+	// included, as Board::getRow() gives it. Neighbouring matrices sit next to each other so a vector register
+	// holds the same row of several of them
+	struct BoardBatch {
+		int count = 0;
+		alignas(32) Board::Row rows[Board::height][batchSize] = {};
+
+		// adds a matrix to the batch
+		inline void add(const Board& board) {
+			for (int r = 0; r < Board::height; ++r) rows[r][count] = board.getRow(r);
+			++count;
+		}
+	};
+
+	// the features of every matrix of a batch, a feature at a time
+	struct FeatureBatch {
+		alignas(32) std::uint16_t height[batchSize];      // the heights of all columns added up
+		alignas(32) std::uint16_t holes[batchSize];       // empty cells with a taken cell somewhere above them
+		alignas(32) std::uint16_t bumpiness[batchSize];   // how much neighbouring columns differ in height, added up
+		alignas(32) std::uint16_t wells[batchSize];       // empty cells above their column with both neighbours taken
+		alignas(32) std::uint16_t transitions[batchSize]; // changes between taken and empty along every row, borders included
+	};
+
+	// the bits of a row that the features look at
+	constexpr Board::Row cellBits = Board::Row(Board::fullRow & ~Board::emptyRow);
+	// bit c+1 stands for the pair of columns c and c+1
+	constexpr Board::Row pairBits = Board::Row(cellBits & (cellBits >> 1));
+	// bit i stands for the pair of bits i and i+1, borders included
+	constexpr Board::Row transitionBits = Board::Row(Board::fullRow >> 1);
+
+	// measures matrix i of a batch. Every feature comes from the rows top to bottom: the columns taken at or
+	// above a row (covered) add up to the heights, and the empty cells under them are holes
+	inline void measureOne(const BoardBatch& batch,FeatureBatch& features,const int& i) {
+		unsigned covered = 0,height = 0,holes = 0,bumpiness = 0,wells = 0,transitions = 0;
+		for (int r = 0; r < Board::height; ++r) {
+			unsigned row = batch.rows[r][i],cells = row & cellBits;
+			holes += bitCount(~cells & covered & cellBits);
+			covered |= cells;
+			height += bitCount(covered);
+			bumpiness += bitCount((covered ^ (covered >> 1)) & pairBits);
+			wells += bitCount(~row & (row << 1) & (row >> 1) & ~covered & cellBits);
+			transitions += bitCount((row ^ (row >> 1)) & transitionBits);
+		}
+		features.height[i] = height; features.holes[i] = holes; features.bumpiness[i] = bumpiness;
+		features.wells[i] = wells; features.transitions[i] = transitions;
+	}
+
+	// measures the matrices one at a time
+	inline void measureScalar(const BoardBatch& batch,FeatureBatch& features) {
+		for (int i = 0; i < batch.count; ++i) measureOne(batch,features,i);
+	}
+
+#ifdef TETRIS_SIMD
+	// measures the matrices one at a time with the popcnt instruction. A build for plain x86-64 has no popcount
+	// instruction to turn bitCount() into, so measureScalar() calls into the runtime library for every count
+	__attribute__((target("popcnt"))) inline void measurePopcnt(const BoardBatch& batch,FeatureBatch& features) {
+		for (int i = 0; i < batch.count; ++i) measureOne(batch,features,i);
+	}
+
+	// number of set bits in every 16 bit lane, looked up a nibble at a time
+	__attribute__((target("sse4.2"))) inline __m128i bitCount16(const __m128i& v) {
+		const __m128i table = _mm_setr_epi8(0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4),nibble = _mm_set1_epi8(0x0f);
+		__m128i bytes = _mm_add_epi8(_mm_shuffle_epi8(table,_mm_and_si128(v,nibble)),_mm_shuffle_epi8(table,_mm_and_si128(_mm_srli_epi16(v,4),nibble)));
+		return _mm_add_epi16(_mm_and_si128(bytes,_mm_set1_epi16(0xff)),_mm_srli_epi16(bytes,8));
+	}
+
+	// measures 8 matrices at a time, the same way as measureScalar()
+	__attribute__((target("sse4.2"))) inline void measureSse42(const BoardBatch& batch,FeatureBatch& features) {
+		const __m128i cells = _mm_set1_epi16(cellBits),pairs = _mm_set1_epi16(pairBits),edges = _mm_set1_epi16(transitionBits);
+		for (int i = 0; i < batch.count; i += 8) {
+			__m128i covered = _mm_setzero_si128(),height = covered,holes = covered,bumpiness = covered,wells = covered,transitions = covered;
+			for (int r = 0; r < Board::height; ++r) {
+				__m128i row = _mm_load_si128(reinterpret_cast<const __m128i*>(&batch.rows[r][i]));
+				__m128i taken = _mm_and_si128(row,cells);
+				holes = _mm_add_epi16(holes,bitCount16(_mm_andnot_si128(taken,_mm_and_si128(covered,cells))));
+				covered = _mm_or_si128(covered,taken);
+				height = _mm_add_epi16(height,bitCount16(covered));
+				bumpiness = _mm_add_epi16(bumpiness,bitCount16(_mm_and_si128(_mm_xor_si128(covered,_mm_srli_epi16(covered,1)),pairs)));
+				__m128i walled = _mm_and_si128(_mm_slli_epi16(row,1),_mm_srli_epi16(row,1));
+				wells = _mm_add_epi16(wells,bitCount16(_mm_andnot_si128(_mm_or_si128(row,covered),_mm_and_si128(walled,cells))));
+				transitions = _mm_add_epi16(transitions,bitCount16(_mm_and_si128(_mm_xor_si128(row,_mm_srli_epi16(row,1)),edges)));
+			}
+			_mm_store_si128(reinterpret_cast<__m128i*>(&features.height[i]),height);
+			_mm_store_si128(reinterpret_cast<__m128i*>(&features.holes[i]),holes);
+			_mm_store_si128(reinterpret_cast<__m128i*>(&features.bumpiness[i]),bumpiness);
+			_mm_store_si128(reinterpret_cast<__m128i*>(&features.wells[i]),wells);
+			_mm_store_si128(reinterpret_cast<__m128i*>(&features.transitions[i]),transitions);
+		}
+	}
+
+	__attribute__((target("avx2"))) inline __m256i bitCount16(const __m256i& v) {
+		const __m256i table = _mm256_setr_epi8(0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4,0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4),nibble = _mm256_set1_epi8(0x0f);
+		__m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(table,_mm256_and_si256(v,nibble)),_mm256_shuffle_epi8(table,_mm256_and_si256(_mm256_srli_epi16(v,4),nibble)));
+		return _mm256_add_epi16(_mm256_and_si256(bytes,_mm256_set1_epi16(0xff)),_mm256_srli_epi16(bytes,8));
+	}
+
+	// measures 16 matrices at a time, the same way as measureScalar()
+	__attribute__((target("avx2"))) inline void measureAvx2(const BoardBatch& batch,FeatureBatch& features) {
+		const __m256i cells = _mm256_set1_epi16(cellBits),pairs = _mm256_set1_epi16(pairBits),edges = _mm256_set1_epi16(transitionBits);
+		for (int i = 0; i < batch.count; i += 16) {
+			__m256i covered = _mm256_setzero_si256(),height = covered,holes = covered,bumpiness = covered,wells = covered,transitions = covered;
+			for (int r = 0; r < Board::height; ++r) {
+				__m256i row = _mm256_load_si256(reinterpret_cast<const __m256i*>(&batch.rows[r][i]));
+				__m256i taken = _mm256_and_si256(row,cells);
+				holes = _mm256_add_epi16(holes,bitCount16(_mm256_andnot_si256(taken,_mm256_and_si256(covered,cells))));
+				covered = _mm256_or_si256(covered,taken);
+				height = _mm256_add_epi16(height,bitCount16(covered));
+				bumpiness = _mm256_add_epi16(bumpiness,bitCount16(_mm256_and_si256(_mm256_xor_si256(covered,_mm256_srli_epi16(covered,1)),pairs)));
+				__m256i walled = _mm256_and_si256(_mm256_slli_epi16(row,1),_mm256_srli_epi16(row,1));
+				wells = _mm256_add_epi16(wells,bitCount16(_mm256_andnot_si256(_mm256_or_si256(row,covered),_mm256_and_si256(walled,cells))));
+				transitions = _mm256_add_epi16(transitions,bitCount16(_mm256_and_si256(_mm256_xor_si256(row,_mm256_srli_epi16(row,1)),edges)));
+			}
+			_mm256_store_si256(reinterpret_cast<__m256i*>(&features.height[i]),height);
+			_mm256_store_si256(reinterpret_cast<__m256i*>(&features.holes[i]),holes);
+			_mm256_store_si256(reinterpret_cast<__m256i*>(&features.bumpiness[i]),bumpiness);
+			_mm256_store_si256(reinterpret_cast<__m256i*>(&features.wells[i]),wells);
+			_mm256_store_si256(reinterpret_cast<__m256i*>(&features.transitions[i]),transitions);
+		}
+	}
+#endif
+
+	typedef void (*Measure)(const BoardBatch&,FeatureBatch&);
+
+	// the widest way of measuring a batch this processor supports, picked the first time it is asked for
+	inline Measure bestMeasure() {
+#ifdef TETRIS_SIMD
+		static const Measure best = __builtin_cpu_supports("avx2") ? measureAvx2 : __builtin_cpu_supports("sse4.2") ? measureSse42
+		                          : __builtin_cpu_supports("popcnt") ? measurePopcnt : measureScalar;
+		return best;
+#else
+		return measureScalar;
+#endif
+	}
+
+	// the name of the way bestMeasure() picked
+	inline const char* bestMeasureName() {
+#ifdef TETRIS_SIMD
+		if (bestMeasure() == measureAvx2) return "avx2";
+		if (bestMeasure() == measureSse42) return "sse4.2";
+		if (bestMeasure() == measurePopcnt) return "popcnt";
+#endif
+		return "scalar";
+	}
+
+	// measures every matrix of a batch
+	inline void measure(const BoardBatch& batch,FeatureBatch& features) { bestMeasure()(batch,features); }
+
+} /* end of namespace tetris */
+//=================================================================================================================================//
+#endif
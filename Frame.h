@@ -0,0 +1,146 @@
+#ifndef FRAME_H
+#define FRAME_H
+//=================================================================================================================================//
+// needed header files
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Escape.h"
+#if defined(__linux__)||defined(__linux)||defined(linux)
+#include <unistd.h>
+#endif
+//=================================================================================================================================//
+
+// namespace to contain all the tools the game needs
+namespace SimpleAssets
+{
+	// gathers everything printed for one frame and sends it to the terminal in a single write
+	class Frame
+	{
+		private:
+		    // what has been printed since the last flush
+		    std::string buffer;
+		    // where frames are written to
+		    int fd = 1;
+
+		    // wrap every frame in the terminal's synchronized update mode (DEC private mode 2026) so
+		    // the terminal draws the frame at once. Terminals without the mode ignore the sequences
+		    bool synchronized = true;
+		    bool opened = false;
+
+		    // write calls and bytes of the last frame sent, and of all frames sent
+		    unsigned lastWrites = 0,lastBytes = 0;
+		    unsigned long long totalWrites = 0,totalBytes = 0,frames = 0;
+
+		    // starts a new frame if nothing has been printed since the last flush
+		    inline void open() {
+		    	if (!opened) { opened = true; if (synchronized) buffer += "\033[?2026h"; }
+		    }
+
+		public:
+		    Frame() { buffer.reserve(16384); } /* constructor */
+
+		    // setter methods
+		    inline void setSynchronized(const bool& value) { this->synchronized = value; }
+		    inline void setOutput(const int& fd) { this->fd = fd; }
+
+		    // getter methods
+		    inline unsigned getLastWrites() const { return this->lastWrites; }
+		    inline unsigned getLastBytes() const { return this->lastBytes; }
+		    inline unsigned long long getTotalWrites() const { return this->totalWrites; }
+		    inline unsigned long long getTotalBytes() const { return this->totalBytes; }
+		    inline unsigned long long getFrames() const { return this->frames; }
+
+		    // how much has been printed since the last flush, to mark where a part of the frame starts
+		    inline std::size_t getSize() { open(); return this->buffer.size(); }
+		    // what has been printed since a mark
+		    inline std::string copy(const std::size_t& from) const { return this->buffer.substr(from); }
+		    // takes back what has been printed since a mark
+		    inline void cut(const std::size_t& from) { this->buffer.resize(from); }
+
+		    // print to the frame
+		    inline Frame& operator<<(const std::string& n) { open(); buffer += n; return *this; }
+		    inline Frame& operator<<(const char* n) { open(); buffer += n; return *this; }
+		    inline Frame& operator<<(const char& n) { open(); buffer += n; return *this; }
+		    inline Frame& operator<<(const Sequence& n) { open(); buffer.append(n.data(),n.length()); return *this; }
+		    // prints a character a number of times
+		    inline Frame& repeat(const std::size_t& count,const char& n) { open(); buffer.append(count,n); return *this; }
+
+		    // sends the frame to the terminal. A partial write is the only reason to write more than once
+		    void flush() {
+		    	if (!opened) return;
+		    	if (synchronized) buffer += "\033[?2026l";
+
+		    	lastWrites = 0; lastBytes = buffer.size();
+		    	const char* data = buffer.data();
+		    	std::size_t remaining = buffer.size();
+		    	while (remaining > 0) {
+#if defined(__linux__)||defined(__linux)||defined(linux)
+		    		ssize_t n = ::write(fd,data,remaining); ++lastWrites;
+		    		if (n < 0 && errno == EINTR) continue;
+		    		if (n <= 0) break;
+#else
+		    		std::size_t n = std::fwrite(data,1,remaining,stdout); std::fflush(stdout); ++lastWrites;
+		    		if (n == 0) break;
+#endif
+		    		data += n; remaining -= n;
+		    	}
+		    	totalWrites += lastWrites; totalBytes += lastBytes; ++frames;
+		    	buffer.clear(); opened = false;
+		    }
+	};
+
+	// every part of the game prints through this frame
+	Frame frame;
+
+	// a page printed once and kept, so showing it again is one copy of its bytes into the frame. The parts of
+	// the page that change are slots: runs of spaces in the page's bytes that are written over before it is shown
+	class CachedPage
+	{
+		private:
+		    std::string bytes;
+		    // where every slot starts in the bytes and how wide it is
+		    std::vector<std::pair<std::size_t,std::size_t>> slots;
+		    std::size_t start = 0;
+		    bool cached = false;
+
+		public:
+		    CachedPage() {} /* constructor */
+
+		    // getter methods
+		    inline bool isCached() const { return this->cached; }
+		    inline std::size_t getSize() const { return this->bytes.size(); }
+
+		    // starts keeping everything printed to the frame as the page
+		    inline void begin() { start = frame.getSize(); slots.clear(); cached = false; }
+		    // prints a slot of a number of characters and returns its number
+		    inline int slot(const std::size_t& width) {
+		    	slots.emplace_back(frame.getSize()-start,width);
+		    	frame.repeat(width,' ');
+		    	return static_cast<int>(slots.size()-1);
+		    }
+		    // stops keeping what is printed. The page was printed to the frame as it was kept, so it is shown too
+		    // unless it is taken back to have its slots written first
+		    inline void end(const bool& shown = true) {
+		    	bytes = frame.copy(start); cached = true;
+		    	if (!shown) frame.cut(start);
+		    }
+
+		    // writes text into a slot, on its left or on its right, cutting it to the slot's width
+		    void patch(const int& slot,const std::string& text,const bool& right = false) {
+		    	std::size_t offset = slots[slot].first,width = slots[slot].second;
+		    	std::size_t length = (text.size() < width) ? text.size() : width;
+		    	std::memset(&bytes[offset],' ',width);
+		    	std::memcpy(&bytes[offset+(right ? width-length : 0)],text.data(),length);
+		    }
+
+		    // prints the page to the frame
+		    inline void show() const { frame << bytes; }
+	};
+
+} /* end of namespace SimpleAssets */
+//=================================================================================================================================//
+#endif
@@ -0,0 +1,221 @@
+#ifndef GAME_ENGINE_H
+#define GAME_ENGINE_H
+//=================================================================================================================================//
+// needed header files
+#include <cstdint>
+#include <random>
+#include "Board.h"
+#include "Pieces.h"
+#include "Kicks.h"
+#include "Generator.h"
+#include "Trace.h"
+//=================================================================================================================================//
+
+// namespace to contain specific assets used during gameplay
+namespace tetris
+{
+	// what can be done to the falling tetromino
+	enum class Action {
+		None,Left,Right,Rotate,Drop
+	};
+	
+	// what the cells of garbage rows are filled with, one past the kinds of tetromino
+	constexpr std::uint8_t garbageKind = 8;
+	
+	class GameEngine;
+	
+	// gets told about everything that happens during a game, so it can be drawn or recorded
+	class GameObserver
+	{
+		public:
+		    virtual ~GameObserver() {} /* destructor */
+		    
+		    virtual void pieceMoved(const GameEngine&) {}
+		    virtual void pieceLocked(const GameEngine&) {}
+		    virtual void linesCleared(const GameEngine&,int) {}
+		    virtual void pieceSpawned(const GameEngine&) {}
+		    virtual void gameOver(const GameEngine&) {}
+	};
+	
+	// a game of tetris without a screen. It owns the matrix, the falling tetromino, the next shape and the
+	// scores, and only changes when it is told to: step() for an action and tick() for gravity
+	class GameEngine
+	{
+		private:
+		    Board board;
+		    
+		    // the falling tetromino and the kind of tetromino that falls after it
+		    Piece current = Piece{Type::Undefined,State::Up,0,0};
+		    Type next = Type::Undefined;
+		    
+		    // selects the shapes from the game's seed
+		    PieceGenerator generator;
+		    
+		    // scores of the game
+		    unsigned score = 0,lines = 0,pieces = 0;
+		    bool over = false;
+		    
+		    // rows of garbage an opponent sent that are added when the falling tetromino lands, and the column of
+		    // the empty cell on every one of them
+		    std::uint8_t holes[Board::height];
+		    int garbage = 0;
+		    
+		    // where a turned tetromino is pushed to when it doesn't fit
+		    const KickTable* kicks = &classicKickTable;
+		    
+		    // told about everything that happens
+		    GameObserver* observer = nullptr;
+		    
+		    // moves the falling tetromino if it fits where it is moved to. Returns true if it moved
+		    inline bool move(const int& rows,const int& columns) {
+		    	Piece piece = current.moved(rows,columns);
+		    	if (!fits(board,piece)) return false;
+		    	current = piece; return true;
+		    }
+		    
+		    void turn(),spawn(),lock();
+		    int checkLine();
+		    
+		public:
+		    GameEngine(const unsigned& seed = std::random_device()(),const Randomizer& randomizer = Randomizer::Bag) { reset(seed,randomizer); } /* constructor */
+		    
+		    // starts a new game whose shapes are selected from a seed. The same seed and randomizer always
+		    // give the same shapes, which is what lets a game be replayed
+		    void reset(const unsigned& seed,const Randomizer& randomizer = Randomizer::Bag);
+		    
+		    // applies an action to the falling tetromino. Returns true if the tetromino landed
+		    bool step(const Action& action);
+		    // rows of garbage to push the matrix up by when the falling tetromino lands, with their empty cell in a
+		    // column. Garbage past a whole matrix is more than enough to end the game and isn't kept
+		    inline void addGarbage(const int& count,const int& hole) {
+		    	for (int i = 0; i < count && garbage < Board::height; ++i) holes[garbage++] = static_cast<std::uint8_t>(hole);
+		    }
+		    // moves the falling tetromino down a row. Returns true if it landed instead
+		    bool tick();
+		    
+		    // setter methods
+		    inline void setObserver(GameObserver* observer) { this->observer = observer; }
+		    inline void setKicks(const KickTable& kicks) { this->kicks = &kicks; }
+		    // sets a position up, for tools that start from somewhere other than an empty matrix
+		    inline void setBoard(const Board& board) { this->board = board; }
+		    inline void setCurrent(const Piece& piece) { this->current = piece; }
+		    
+		    // getter methods
+		    inline const Board& getBoard() const { return this->board; }
+		    inline const KickTable& getKicks() const { return *this->kicks; }
+		    inline const Piece& getCurrent() const { return this->current; }
+		    inline Type getNext() const { return this->next; }
+		    // where a tetromino ends up if it is turned clockwise on this matrix. It is returned as it was if it can't turn
+		    Piece rotated(const Piece& piece) const;
+		    // the falling tetromino where it would land if it was dropped now
+		    inline Piece getGhost() const { return current.moved(dropDistance(board,current),0); }
+		    // the next tetromino where it will spawn
+		    inline Piece getPreview() const { return Piece::spawn(this->next); }
+		    inline unsigned getScore() const { return this->score; }
+		    inline unsigned getLines() const { return this->lines; }
+		    inline unsigned getPieces() const { return this->pieces; }
+		    inline int getGarbage() const { return this->garbage; }
+		    inline unsigned getSeed() const { return this->generator.getSeed(); }
+		    inline Randomizer getRandomizer() const { return this->generator.getRandomizer(); }
+		    inline bool isOver() const { return this->over; }
+	};
+	
+    // turns the falling tetromino 90 degrees clockwise, taking the first position of the kick set that fits. It
+    // stays as it was if none of them fit
+    inline void GameEngine::turn() {
+    	current = rotated(current);
+    }
+    
+    inline Piece GameEngine::rotated(const Piece& piece) const {
+    	Piece turned = piece.turned();
+    	const Kick* tests = kicks->get(piece.type,piece.rotation,turned.rotation);
+    	int count = kicks->count(piece.type,piece.rotation,turned.rotation);
+    	for (int k = 0; k < count; ++k) {
+    		Piece kicked = turned.moved(tests[k].row,tests[k].column);
+    		if (fits(board,kicked)) return kicked;
+    	}
+    	return piece;
+    }
+    
+    inline void GameEngine::reset(const unsigned& seed,const Randomizer& randomizer) {
+    	generator.reset(seed,randomizer);
+    	board.reset();
+    	score = lines = pieces = 0; over = false; garbage = 0;
+    	next = generator.next(); spawn();
+    }
+    
+    // the next shape starts falling and a new next shape is selected
+    inline void GameEngine::spawn() {
+    	current = Piece::spawn(next);
+    	next = generator.next();
+    	
+    	// end the game if the matrix is full
+    	if (!fits(board,current)) {
+    		over = true;
+    		if (observer != nullptr) observer->gameOver(*this);
+    		return;
+    	}
+    	if (observer != nullptr) observer->pieceSpawned(*this);
+    }
+    
+    // checks if lines have been formed on the rows of the tetromino that just landed
+    inline int GameEngine::checkLine() {
+    	TRACE_SCOPE("GameEngine::checkLine");
+    	int cleared = clearLines(board,current);
+    	// every line is worth 3 times the lines cleared with it counted: lines+1 to lines+cleared, added up at once
+    	unsigned n = static_cast<unsigned>(cleared);
+    	score += 3*(n*lines+n*(n+1)/2);
+    	lines += n;
+    	return cleared;
+    }
+    
+    // the tetromino has landed. store it in the matrix, clear lines and bring in the next one
+    inline void GameEngine::lock() {
+    	TRACE_SCOPE("GameEngine::lock");
+    	place(board,current);
+    	++pieces;
+    	if (observer != nullptr) observer->pieceLocked(*this);
+    	
+    	int cleared = checkLine();
+    	if (cleared > 0 && observer != nullptr) observer->linesCleared(*this,cleared);
+    	
+    	// the garbage waiting comes in under the matrix, a run of rows with the same hole at a time
+    	for (int i = 0; i < garbage; ) {
+    		int run = 1;
+    		while (i+run < garbage && holes[i+run] == holes[i]) ++run;
+    		if (!board.raise(run,holes[i],garbageKind)) over = true;
+    		i += run;
+    	}
+    	garbage = 0;
+    	if (over) {
+    		if (observer != nullptr) observer->gameOver(*this);
+    		return;
+    	}
+    	spawn();
+    }
+    
+    inline bool GameEngine::step(const Action& action) {
+    	TRACE_SCOPE("GameEngine::step");
+    	if (over) return false;
+    	switch (action) {
+    		case Action::Left:   move(0,-1); break;
+    		case Action::Right:  move(0,1); break;
+    		case Action::Rotate: turn(); break;
+    		case Action::Drop:   current = getGhost(); lock(); return true;
+    		case Action::None:   return false;
+    	}
+    	if (observer != nullptr) observer->pieceMoved(*this);
+    	return false;
+    }
+    
+    inline bool GameEngine::tick() {
+    	TRACE_SCOPE("GameEngine::tick");
+    	if (over) return false;
+    	if (!move(1,0)) { lock(); return true; }
+    	if (observer != nullptr) observer->pieceMoved(*this);
+    	return false;
+    }
+    
+} /* end of namespace tetris */
+//=================================================================================================================================//
+#endif
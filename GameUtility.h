@@ -1,22 +1,45 @@
 #ifndef GAME_UTILITY_H
 #define GAME_UTILITY_H
+#include <cstdio>
+#include <ctime>
 #include "SimpleAssets.h"
+#include "History.h"
+#include "EventLoop.h"
 //===================================================================================================================================================//
 
 // for convienience...
 using namespace SimpleAssets;
 
+// starts a game on the page newGame() draws. Only the game defines it: the tools that draw the pages never
+// start one, so everything that leads to it is inline and left out of them
+void startNewGame();
+
 // namespace to contain the game's interface
 namespace interface
 {
 	
-	void menu() {
-		// set the current screen page
-		screen.setPage(Page::Menu);
-		// set the specific selector and its options for this page
-		screen.setSelector(0);
-		screen.setCursorDefaults(35,1,normal);
-		
+	// every page that doesn't change is printed once and kept. The scores page is kept with slots for its scores
+	CachedPage menuPage,difficultyPage,scoresPage,instructionsPage,settingsPage;
+	
+	// prints a page the first time it is shown and shows the kept one after that. The cursor is put back once
+	// at the end of the page rather than after everything on it
+	template <typename Draw>
+	void showPage(CachedPage& page,Draw draw,const bool& shown = true) {
+		if (page.isCached()) { if (shown) page.show(); return; }
+		screen.setRestoring(false);
+		page.begin();
+		draw();
+		screen.setRestoring(true);
+		page.end(shown);
+	}
+	
+	// prints a slot of a kept page at a row and column, in a color, and returns its number
+	int slot(CachedPage& page,const int& row,const int& col,const std::size_t& width,const textColor& clr) {
+		frame << cursor(row,col) << color(clr);
+		return page.slot(width);
+	}
+	
+	void drawMenu() {
 		// display the game's name;
 		screen.display("oooo [",4,16,green);
 		screen.display("T E T R I S   G A M E",4,23,yellow);
@@ -28,12 +51,22 @@ namespace interface
         }
         // display tip info
         screen.display("Press 5 to select an option",29,20,darkgray);
+	}
+	
+	void menu() {
+		// set the current screen page
+		screen.setPage(Page::Menu);
+		// set the specific selector and its options for this page
+		screen.setSelector(0);
+		screen.setCursorDefaults(35,1,normal);
+		showPage(menuPage,drawMenu);
         
         // retrieve the game data if it hasn't been retrieved. This happens once per game run
-        if (!tetrisData->getHasData()) { tetrisData->retrieveGameData(); }
+        if (!tetrisData->getHasData()) { tetrisData->retrieveGameData(); tetris::gameHistory.open(tetrisData->getFolder()); }
 	}
 	
-	void newGame() {
+	// draws the game's page around the matrix
+	void gamePage() {
 		screen.setPage(Page::NewGame);
 		// create the matrix
 		screen.createContainer(22,20,8,13,blue);
@@ -45,23 +78,21 @@ namespace interface
 		screen.createContainer(15,5,4,45,blue);
 		screen.display("Game Level: "+color(green)+std::to_string(GameLevelNumber),12,46,yellow);
 		screen.display(std::string(20,'_'),13,42,blue);
-		screen.display(color(pink)+center("Score: "+color(green)+std::to_string(tetrisData->getScore()),15,42,62,green));
-		screen.display(color(pink)+center("Lines: "+color(green)+std::to_string(tetrisData->getLinesCleared()),18,42,62,green));
+		// the score and lines are drawn by the game's renderer
 		screen.display(std::string(20,'_'),19,42,blue);
 		screen.display(color(yellow)+center("Key Pressed: "+color(green)+"0",21,42,62,green));
 		screen.display(std::string(20,'_'),22,42,blue);
 		// set the cursor derails for this page
 		screen.setCursorDefaults(21,58,green);
-		std::cout << std::flush; startNewGame();
 	}
 	
-	void difficulty() {
-		// set the current screen page
-		screen.setPage(Page::Difficulty);
-		// set the specific selector and its options for this page
-		screen.setSelector(1);
-		// level will always be set when this interface runs
-		levelSet = true;
+	inline void newGame() {
+		gamePage();
+		// the page is sent along with the first frame of the game
+		startNewGame();
+	}
+	
+	void drawDifficulty() {
 		// display the current screen page title
 		screen.display(" DIFFICULTY ",3,29,white,Red);
 		screen.display("Select Level",6,10,green);
@@ -72,30 +103,86 @@ namespace interface
 		    screen.display(screen.getOptions(1)[opt]+cursor(row,55)+color(white)+"o",row,12,cyan);
 		}
 		screen.display("Press # to go back",31,25,darkgray);
+	}
+	
+	void difficulty() {
+		// set the current screen page
+		screen.setPage(Page::Difficulty);
+		// set the specific selector and its options for this page
+		screen.setSelector(1);
+		// level will always be set when this interface runs
+		levelSet = true;
+		showPage(difficultyPage,drawDifficulty);
+		// the level selected is marked on the kept page
 		setDifficulty();
 		
 		// the user may want to modify the level so allow modification
 		levelSet = false;
 	}
 	
-	void scores() {
-		screen.setPage(Page::Score);
+	// the slots of the scores page
+	struct ScoreSlots {
+		int highestLines,highestScore,played,total,median,top,level,best[5],recent;
+	} scoreSlots;
+	
+	void drawScores() {
 		screen.display(" SCORES ",3,31,white,Red);
 		// draw borders for content
 		screen.createContainer(50,23,5,9,blue,'_','_','\0');
 		screen.display("Single Game: ",7,10,white);
-	    screen.display("Highest lines cleared:"+space(tetrisData->getHighestLines(),26)+color(green)+std::to_string(tetrisData->getHighestLines()),9,10,pink);
-		screen.display("Lifetime: ",13,10,white);
-		screen.display("Games Played:"+space(tetrisData->getGamesPlayed(),35)+color(green)+std::to_string(tetrisData->getGamesPlayed()),15,10,pink);
-		screen.display("Total lines Cleared:"+space(tetrisData->getTotalLinesCleared(),28)+color(green)+std::to_string(tetrisData->getTotalLinesCleared()),17,10,pink);
-		screen.display("Highest score:"+space(tetrisData->getHighestScore(),34)+color(green)+std::to_string(tetrisData->getHighestScore()),24,10,cyan);
+		screen.display("Highest lines cleared:",8,10,pink); scoreSlots.highestLines = slot(scoresPage,8,32,26,green);
+		screen.display("Highest score:",9,10,cyan); scoreSlots.highestScore = slot(scoresPage,9,24,34,green);
+		screen.display("Lifetime: ",11,10,white);
+		screen.display("Games Played:",12,10,pink); scoreSlots.played = slot(scoresPage,12,23,35,green);
+		screen.display("Total lines Cleared:",13,10,pink); scoreSlots.total = slot(scoresPage,13,30,28,green);
+		screen.display("Median score:",14,10,pink); scoreSlots.median = slot(scoresPage,14,23,35,green);
+		screen.display("Top 10% score:",15,10,pink); scoreSlots.top = slot(scoresPage,15,24,34,green);
+		
+		screen.display("Best at level ",17,10,white); scoreSlots.level = slot(scoresPage,17,24,1,white);
+		screen.display(":",17,25,white);
+		for (int i = 0; i < 5; ++i) scoreSlots.best[i] = slot(scoresPage,18+i,10,44,(i == 0) ? cyan : pink);
+		screen.display("Last games: ",24,10,white); scoreSlots.recent = slot(scoresPage,25,10,48,green);
 		screen.display("Press # to go back",31,25,darkgray);
 	}
 	
-	void instructions() {
-		// set the current screen page
-		screen.setPage(Page::Instructions);
+	void scores() {
+		using tetris::gameHistory;
+		screen.setPage(Page::Score);
+		// the scores are written into the kept page before it is shown
+		showPage(scoresPage,drawScores,false);
+		scoresPage.patch(scoreSlots.highestLines,std::to_string(tetrisData->getHighestLines()),true);
+		scoresPage.patch(scoreSlots.highestScore,std::to_string(tetrisData->getHighestScore()),true);
+		scoresPage.patch(scoreSlots.played,std::to_string(tetrisData->getGamesPlayed()),true);
+		scoresPage.patch(scoreSlots.total,std::to_string(tetrisData->getTotalLinesCleared()),true);
+		// percentiles and the best games come from the history's index, so they show up at once however many
+		// games have been played
+		scoresPage.patch(scoreSlots.median,std::to_string(gameHistory.percentile(50)),true);
+		scoresPage.patch(scoreSlots.top,std::to_string(gameHistory.percentile(90)),true);
 		
+		scoresPage.patch(scoreSlots.level,std::to_string(GameLevelNumber));
+		char line[64];
+		int count = gameHistory.getTopCount(GameLevelNumber);
+		for (int i = 0; i < 5; ++i) {
+			line[0] = '\0';
+			if (i < count) {
+				const tetris::GameRecord& game = gameHistory.getTop(GameLevelNumber,i);
+				std::time_t ended = game.time;
+				char date[16] = "";
+				if (const std::tm* when = std::localtime(&ended)) std::strftime(date,sizeof(date),"%Y-%m-%d",when);
+				std::snprintf(line,sizeof(line),"%d. %9u points %6u lines  %s",i+1,game.score,game.lines,date);
+			} else if (i == 0) {
+				std::snprintf(line,sizeof(line),"no games yet");
+			}
+			scoresPage.patch(scoreSlots.best[i],line);
+		}
+		
+		std::string recent;
+		for (int i = 0; i < 5 && i < gameHistory.getRecentCount(); ++i) recent += std::to_string(gameHistory.getRecent(i).score)+"  ";
+		scoresPage.patch(scoreSlots.recent,recent);
+		scoresPage.show();
+	}
+	
+	void drawInstructions() {
 		// display the current screen page title
 		screen.display(" INSTRUCTIONS ",3,28,white,Red);
 		screen.display("Controlling the Tetromino",7,9,green);
@@ -118,15 +205,25 @@ namespace interface
 	    screen.display("Press # to go back",31,25,darkgray);
 	}
 	
+	void instructions() {
+		// set the current screen page
+		screen.setPage(Page::Instructions);
+		showPage(instructionsPage,drawInstructions);
+	}
+	
+	void drawSettings() {
+		screen.display(" SETTINGS ",3,30,white,Red);
+	}
+	
 	void settings() {
 		screen.setPage(Page::Settings);
-		screen.display(" SETTINGS ",3,30,white,Red);
+		showPage(settingsPage,drawSettings);
 	}
 	
 } /* end of namespace interface */
 
 // processes the option selected by the user
-void userOption(const int& selectorPosition) {
+inline void userOption(const int& selectorPosition = 0) {
 	// the user wants to go back
 	if (screen.getCommand() == '#' && screen.getPage() != Page::Menu) { screen.clear(); interface::menu(); }
 	// the user wants to select an option
@@ -144,22 +241,56 @@ void userOption(const int& selectorPosition) {
 	} else if (screen.getCommand() == '5' && screen.getPage() == Page::Difficulty) { setDifficulty(); }
 }
 
-// starts executing the program
-void runGame() {
+// highlights and processes a selectable option of the page on screen
+inline void SimpleAssets::Screen::initialize_selection() {
+	// highlight the option
+	if (page == Page::Menu || page == Page::Difficulty) {
+	    selector->indicateOption(options[pageIndex][selector->getCount()],options_cols[pageIndex][selector->getCount()]);
+	}
+    // wait for user input
+    setCommand();
+   
+    // only checks if the user wants to go back
+    if (page != Page::Menu) userOption();
+    
+	if (page == Page::Menu || page == Page::Difficulty) {
+		if (command == '8' || command == '2') {
+		    // erase the previous position of the selector
+		    selector->erase();
+			
+			// change the selector's position
+            selector->scroll(command);
+		
+		// selected an option
+	    } else if (command == '5') {
+	    	// process the option the user selected
+	    	userOption(selector->getRow());
+	    }
+	}
+}
+
+// draws the borders every page is drawn in
+void createScreen() {
 	// hide the cursor
-	std::cout << "\033[?25l" << std::endl;
+	frame << "\033[?25l\n";
 	// create a screen container for display
 	screen.createContainer(59,33,1,5,blue);
 	// create an inner screen container
 	screen.createContainer(57,31,2,6,blue,'"','_','"');
+}
+
+// starts executing the program
+inline void runGame() {
+	createScreen();
 	interface::menu();
 	setDifficulty();
-	// never stop running the game
+	// keep running the game until a signal asks it to stop
 	// NOTE: no form of recursion is used to keep the game running
 	// control will ALWAYS come back to this loop no matter where it goes
-	while (true) {
+	while (!tetris::stopRequested) {
 		screen.initialize_selection();
 	}
+	frame << cursor(35,1) << color() << "\033[?25h"; frame.flush();
 }
 //===================================================================================================================================================//
 #endif
\ No newline at end of file
@@ -0,0 +1,95 @@
+#ifndef GAME_VIEW_H
+#define GAME_VIEW_H
+//=================================================================================================================================//
+// needed header files
+#include <string>
+#include "SimpleAssets.h"
+#include "GameEngine.h"
+#include "Renderer.h"
+//=================================================================================================================================//
+
+// for convienience...
+using namespace SimpleAssets;
+
+// namespace to contain specific assets used during gameplay
+namespace tetris
+{
+	// screen row and column of the top left cell of the matrix
+	const int matrixTop = 9, matrixLeft = 14;
+
+	// color of each kind of tetromino, in the order of Type, and of garbage
+	const bcgColor brickColors[9] = {Normal,Red,Pink,Green,Yellow,Cyan,Blue,DarkGray,White};
+
+	// draws the matrix, the next shape and the scores, sending only what changed to the screen
+	Renderer renderer;
+
+    // draws a score centered between the margin and the border
+    void drawScore(const int& row,const std::string& label,const unsigned& value) {
+    	std::string number = std::to_string(value);
+    	int column = 52-static_cast<int>(label.length()+number.length())/2;
+    	renderer.fill(row,42,20,' ',normal,Normal);
+    	renderer.text(row,column,label,pink,Normal);
+    	renderer.text(row,column+label.length(),number,green,Normal);
+    }
+
+    // updates the scores during gameplay
+    void updateScores(const GameEngine& engine) {
+    	drawScore(15,"Score: ",engine.getScore());
+    	drawScore(18,"Lines: ",engine.getLines());
+    }
+
+    // shows how many microseconds it took from a key being pressed to it being handled and drawn
+    void drawLatency(const unsigned& latency) {
+    	drawScore(24,"Latency(us): ",latency);
+    }
+
+    // draws a block of a tetromino at a screen position
+    inline void drawBrick(const int& row,const int& column,const Type& type) {
+    	bcgColor brickColor = brickColors[static_cast<int>(type)];
+    	renderer.put(row,column,'[',white,brickColor); renderer.put(row,column+1,']',white,brickColor);
+    }
+
+    // draws the matrix from a board, with a falling tetromino and its ghost on top of it. The matrix is drawn with
+    // its top left cell at a screen position, which is the game page's matrix unless another is given
+    void drawMatrix(const Board& board,const Piece& piece,const int& top = matrixTop,const int& left = matrixLeft) {
+    	for (int r = 0; r < Board::height; ++r) {
+    		for (int c = 0; c < Board::width; ++c) {
+    			if (board.occupied(r,c)) drawBrick(top+r,left+2*c,static_cast<Type>(board.getKind(r,c)));
+    			else renderer.fill(top+r,left+2*c,2,' ',normal,Normal);
+    		}
+    	}
+    	// the ghost shows where the tetromino would land, under the tetromino itself
+    	Piece ghost = piece.moved(dropDistance(board,piece),0);
+    	for (int i = 0; i < 4; ++i) {
+    		renderer.put(top+ghost.row(i),left+2*ghost.column(i),'[',darkgray,Normal);
+    		renderer.put(top+ghost.row(i),left+2*ghost.column(i)+1,']',darkgray,Normal);
+    	}
+    	for (int i = 0; i < 4; ++i) drawBrick(top+piece.row(i),left+2*piece.column(i),piece.type);
+    }
+    void drawMatrix(const GameEngine& engine,const int& top = matrixTop,const int& left = matrixLeft) {
+    	drawMatrix(engine.getBoard(),engine.getCurrent(),top,left);
+    }
+
+    // draws the next shape in its box, 2 rows above and 14 columns to the right of where it will spawn
+    void drawNextShape(const Type& next) {
+    	for (int i = 7; i <= 8; ++i) renderer.fill(i,48,10,' ',normal,Normal);
+    	Piece preview = Piece::spawn(next);
+    	for (int i = 0; i < 4; ++i) drawBrick(matrixTop+preview.row(i)-2,matrixLeft+2*(preview.column(i)+14),preview.type);
+    }
+    void drawNextShape(const GameEngine& engine) { drawNextShape(engine.getNext()); }
+
+    // draws a game on the terminal as it is played
+    class TerminalView : public GameObserver
+    {
+    	public:
+    	    // draws everything, for the start of a game
+    	    void redraw(const GameEngine& engine) { drawMatrix(engine); drawNextShape(engine); updateScores(engine); }
+
+    	    void pieceMoved(const GameEngine& engine) { drawMatrix(engine); }
+    	    void linesCleared(const GameEngine& engine,int) { updateScores(engine); }
+    	    void pieceSpawned(const GameEngine& engine) { drawMatrix(engine); drawNextShape(engine); }
+    };
+
+} /* end of namespace tetris */
+//=================================================================================================================================//
+#endif
@@ -0,0 +1,117 @@
+#ifndef GENERATOR_H
+#define GENERATOR_H
+//=================================================================================================================================//
+// needed header files
+#include <cstddef>
+#include <cstdint>
+#include "Pieces.h"
+//=================================================================================================================================//
+
+// namespace to contain specific assets used during gameplay
+namespace tetris
+{
+	// how the shapes of a game are picked
+	enum class Randomizer : std::uint8_t {
+		Bag,    // every run of 7 tetrominoes has one of each shape, in a random order
+		Uniform // every shape is picked on its own, so a shape can go missing for any number of tetrominoes
+	};
+
+	// a small, fast random number generator (xoshiro128**). The same seed always gives the same numbers
+	class Xoshiro128
+	{
+		private:
+		    std::uint32_t state[4] = {};
+
+		    static inline std::uint32_t rotl(const std::uint32_t& x,const int& k) { return (x << k) | (x >> (32-k)); }
+
+		public:
+		    Xoshiro128(const std::uint32_t& seed = 0) { reseed(seed); } /* constructor */
+
+		    // spreads a seed over the whole state with splitmix64, so close seeds still give unrelated numbers
+		    void reseed(const std::uint32_t& seed) {
+		    	std::uint64_t x = seed;
+		    	for (int i = 0; i < 4; i += 2) {
+		    		std::uint64_t z = (x += 0x9e3779b97f4a7c15ull);
+		    		z = (z ^ (z >> 30))*0xbf58476d1ce4e5b9ull;
+		    		z = (z ^ (z >> 27))*0x94d049bb133111ebull;
+		    		z ^= z >> 31;
+		    		state[i] = static_cast<std::uint32_t>(z); state[i+1] = static_cast<std::uint32_t>(z >> 32);
+		    	}
+		    }
+
+		    inline std::uint32_t operator()() {
+		    	std::uint32_t result = rotl(state[1]*5,7)*9,t = state[1] << 9;
+		    	state[2] ^= state[0]; state[3] ^= state[1]; state[1] ^= state[2]; state[0] ^= state[3];
+		    	state[2] ^= t; state[3] = rotl(state[3],11);
+		    	return result;
+		    }
+
+		    // a number from 0 to bound-1. Scaling the high bits is close enough to even for bounds this small
+		    inline unsigned below(const unsigned& bound) {
+		    	return static_cast<unsigned>((std::uint64_t((*this)())*bound) >> 32);
+		    }
+	};
+
+	// picks the shapes of a game from a seed. Shapes are made a batch at a time into a queue, so the game only
+	// reads the next one from memory, and fill() hands whole batches out for games played without a screen
+	class PieceGenerator
+	{
+		private:
+		    static constexpr int queueSize = 7*8;
+
+		    Xoshiro128 random;
+		    unsigned seed = 0;
+		    Randomizer randomizer = Randomizer::Bag;
+
+		    Type queue[queueSize];
+		    int position = queueSize;
+
+		    // makes the next shapes into out
+		    void generate(Type* out,const std::size_t& count) {
+		    	if (randomizer == Randomizer::Uniform) {
+		    		for (std::size_t i = 0; i < count; ++i) out[i] = static_cast<Type>(random.below(7)+1);
+		    		return;
+		    	}
+		    	// count is always a whole number of bags here
+		    	for (std::size_t bag = 0; bag < count; bag += 7) {
+		    		Type* shapes = out+bag;
+		    		for (int i = 0; i < 7; ++i) shapes[i] = static_cast<Type>(i+1);
+		    		for (int i = 6; i > 0; --i) {
+		    			int j = static_cast<int>(random.below(i+1));
+		    			Type swapped = shapes[i]; shapes[i] = shapes[j]; shapes[j] = swapped;
+		    		}
+		    	}
+		    }
+
+		public:
+		    PieceGenerator(const unsigned& seed = 0,const Randomizer& randomizer = Randomizer::Bag) { reset(seed,randomizer); } /* constructor */
+
+		    // starts again from a seed
+		    void reset(const unsigned& seed,const Randomizer& randomizer) {
+		    	this->seed = seed; this->randomizer = randomizer;
+		    	random.reseed(seed);
+		    	position = queueSize;
+		    }
+
+		    // getter methods
+		    inline unsigned getSeed() const { return this->seed; }
+		    inline Randomizer getRandomizer() const { return this->randomizer; }
+
+		    // the next shape
+		    inline Type next() {
+		    	if (position == queueSize) { generate(queue,queueSize); position = 0; }
+		    	return queue[position++];
+		    }
+
+		    // the next count shapes, in the order next() would give them
+		    void fill(Type* out,std::size_t count) {
+		    	for (; count > 0 && position < queueSize; --count) *out++ = queue[position++];
+		    	std::size_t whole = count-count%queueSize;
+		    	generate(out,whole);
+		    	for (std::size_t i = whole; i < count; ++i) out[i] = next();
+		    }
+	};
+
+} /* end of namespace tetris */
+//=================================================================================================================================//
+#endif
@@ -0,0 +1,270 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+//=================================================================================================================================//
+// needed header files
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include "Board.h"
+#include "Trace.h"
+#if defined(__linux__)||defined(__linux)||defined(linux)
+#define TETRIS_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+//=================================================================================================================================//
+
+// namespace to contain specific assets used during gameplay
+namespace tetris
+{
+	// a game that was played to the end
+	struct GameRecord {
+		std::uint32_t score = 0,lines = 0,pieces = 0;
+		std::uint32_t seed = 0;
+		std::uint32_t duration = 0;  // milliseconds
+		std::uint32_t time = 0;      // when the game ended, in seconds since 1970
+		std::uint8_t level = 0;
+		std::uint8_t randomizer = 0;
+	};
+
+	// what the game history is queried through. It holds a summary of the whole log, kept up to date as games
+	// are added, so nothing has to read the log to answer a query. It is a cache of the log: if it is lost or
+	// falls behind it is made again from the log, so it is stored the way this machine lays it out in memory
+	struct HistoryIndex {
+		static constexpr std::uint32_t version = 1;
+		static constexpr int levels = 7;        // level 0 (not chosen yet) to level 6
+		static constexpr int topCount = 10;     // best games kept for every level
+		static constexpr int recentCount = 10;  // latest games kept
+		static constexpr int buckets = 464;     // 16 a power of 2 for every score a 32 bit number can hold
+
+		char magic[4];
+		std::uint32_t indexVersion;
+		std::uint64_t logSize;   // bytes of the log this index has taken in
+		std::uint64_t games;
+
+		// the best games of every level, best first
+		std::uint32_t topCounts[levels];
+		GameRecord top[levels][topCount];
+
+		// the latest games, in a ring where next is where the next one goes
+		std::uint32_t recentCounts,recentNext;
+		GameRecord recent[recentCount];
+
+		// how many games scored in each range of scores, for percentiles
+		std::uint32_t histogram[buckets];
+
+		// the range of scores a score is counted in: every score under 16 has its own, then every power of 2
+		// is split into 16 ranges, so a percentile is within 1/16 of the real score
+		static inline int bucketOf(const std::uint32_t& score) {
+			if (score < 16) return static_cast<int>(score);
+			int power = highestBit(score);
+			return (power-3)*16+static_cast<int>((score >> (power-4)) & 15);
+		}
+		// the lowest score counted in a range
+		static inline std::uint32_t lowestOf(const int& bucket) {
+			if (bucket < 16) return static_cast<std::uint32_t>(bucket);
+			return std::uint32_t(16+bucket%16) << (bucket/16-1);
+		}
+	};
+	static_assert(std::is_trivially_copyable<HistoryIndex>::value,"the index is copied to and from a file as it is");
+
+	// every game played, in a log that games are only ever added to, and an index of it in a file mapped into
+	// memory. A log is laid out as:
+	//     "THLG" and a version (4 bytes, little endian), then every game as 32 bytes: the score, lines, pieces,
+	//     seed, duration and time (4 bytes each, little endian), the level and randomizer (1 byte each), 2 spare
+	//     bytes, then a checksum (FNV-1a) of the 28 bytes before it
+	// a game is added with a single write to the end of the log, so a game that stops while one is added leaves
+	// at worst a cut-off record at the end, which is dropped the next time the log is opened
+	class History
+	{
+		private:
+		    static constexpr std::uint32_t logVersion = 1;
+		    static constexpr std::size_t headerSize = 8,recordSize = 32;
+
+		    std::string logPath;
+		    HistoryIndex* index = nullptr;
+		    // the index when it couldn't be mapped from its file
+		    std::unique_ptr<HistoryIndex> local;
+#ifdef TETRIS_MMAP
+		    int indexFile = -1;
+#endif
+
+		    static inline void put(unsigned char* bytes,const std::uint32_t& value) {
+		    	for (int i = 0; i < 4; ++i) bytes[i] = static_cast<unsigned char>(value >> (8*i));
+		    }
+		    static inline std::uint32_t get(const unsigned char* bytes) {
+		    	return bytes[0] | (std::uint32_t(bytes[1]) << 8) | (std::uint32_t(bytes[2]) << 16) | (std::uint32_t(bytes[3]) << 24);
+		    }
+		    static std::uint32_t checksum(const unsigned char* bytes,const std::size_t& size) {
+		    	std::uint32_t hash = 2166136261u;
+		    	for (std::size_t i = 0; i < size; ++i) hash = (hash ^ bytes[i])*16777619u;
+		    	return hash;
+		    }
+
+		    static void encode(const GameRecord& game,unsigned char* record) {
+		    	put(record,game.score); put(record+4,game.lines); put(record+8,game.pieces);
+		    	put(record+12,game.seed); put(record+16,game.duration); put(record+20,game.time);
+		    	record[24] = game.level; record[25] = game.randomizer; record[26] = record[27] = 0;
+		    	put(record+28,checksum(record,28));
+		    }
+		    static bool decode(const unsigned char* record,GameRecord& game) {
+		    	if (get(record+28) != checksum(record,28)) return false;
+		    	game.score = get(record); game.lines = get(record+4); game.pieces = get(record+8);
+		    	game.seed = get(record+12); game.duration = get(record+16); game.time = get(record+20);
+		    	game.level = record[24]; game.randomizer = record[25];
+		    	return true;
+		    }
+
+		    // starts the index again from an empty log
+		    void clearIndex() {
+		    	*index = HistoryIndex();
+		    	std::memcpy(index->magic,"THIX",4);
+		    	index->indexVersion = HistoryIndex::version;
+		    	index->logSize = headerSize;
+		    }
+
+		    // takes a game into the index
+		    void insert(const GameRecord& game) {
+		    	int level = (game.level < HistoryIndex::levels) ? game.level : HistoryIndex::levels-1;
+		    	std::uint32_t& count = index->topCounts[level];
+		    	GameRecord* top = index->top[level];
+		    	if (count < HistoryIndex::topCount || game.score > top[count-1].score) {
+		    		// slide the worse games down a place to make room for it
+		    		int at = (count < HistoryIndex::topCount) ? static_cast<int>(count++) : HistoryIndex::topCount-1;
+		    		for (; at > 0 && top[at-1].score < game.score; --at) top[at] = top[at-1];
+		    		top[at] = game;
+		    	}
+		    	index->recent[index->recentNext] = game;
+		    	index->recentNext = (index->recentNext+1)%HistoryIndex::recentCount;
+		    	if (index->recentCounts < HistoryIndex::recentCount) ++index->recentCounts;
+		    	++index->histogram[HistoryIndex::bucketOf(game.score)];
+		    	++index->games;
+		    }
+
+		    // maps the index file into memory, or keeps the index in memory if it can't be
+		    void mapIndex(const std::string& path) {
+#ifdef TETRIS_MMAP
+		    	indexFile = ::open(path.c_str(),O_RDWR | O_CREAT,0644);
+		    	if (indexFile >= 0 && ftruncate(indexFile,sizeof(HistoryIndex)) == 0) {
+		    		void* memory = mmap(nullptr,sizeof(HistoryIndex),PROT_READ | PROT_WRITE,MAP_SHARED,indexFile,0);
+		    		if (memory != MAP_FAILED) { index = static_cast<HistoryIndex*>(memory); return; }
+		    	}
+		    	if (indexFile >= 0) { ::close(indexFile); indexFile = -1; }
+#else
+		    	(void)path;
+#endif
+		    	local.reset(new HistoryIndex());
+		    	index = local.get();
+		    	clearIndex();
+		    }
+
+		public:
+		    History() {} /* constructor */
+		    ~History() { close(); } /* destructor */
+		    History(const History&) = delete;
+		    History& operator=(const History&) = delete;
+
+		    // opens the history kept in a folder, creating it if it isn't there. Only the games added to the log
+		    // since the index was last updated are read, which is none unless the game stopped while adding one
+		    void open(const std::string& folder) {
+		    	TRACE_SCOPE("History::open");
+		    	close();
+		    	logPath = folder+"history.log";
+		    	mapIndex(folder+"history.idx");
+
+		    	std::FILE* log = std::fopen(logPath.c_str(),"rb");
+		    	unsigned char header[headerSize] = {'T','H','L','G'};
+		    	put(header+4,logVersion);
+		    	unsigned char read[headerSize];
+		    	if (log == nullptr || std::fread(read,1,headerSize,log) != headerSize || std::memcmp(read,header,headerSize) != 0) {
+		    		// no log yet, or not one this version can read, which is put aside: start a new one
+		    		if (log != nullptr) { std::fclose(log); std::rename(logPath.c_str(),(logPath+".old").c_str()); }
+		    		log = std::fopen(logPath.c_str(),"wb");
+		    		if (log != nullptr) { std::fwrite(header,1,headerSize,log); std::fclose(log); }
+		    		clearIndex();
+		    		return;
+		    	}
+		    	std::fseek(log,0,SEEK_END);
+		    	std::uint64_t size = static_cast<std::uint64_t>(std::ftell(log));
+		    	std::uint64_t whole = size-(size-headerSize)%recordSize;
+
+		    	// an index of another log, or of more of this log than there is, is made again
+		    	if (std::memcmp(index->magic,"THIX",4) != 0 || index->indexVersion != HistoryIndex::version
+		    	 || index->logSize > whole || (index->logSize-headerSize)%recordSize != 0) clearIndex();
+		    	std::fseek(log,static_cast<long>(index->logSize),SEEK_SET);
+		    	unsigned char record[recordSize];
+		    	GameRecord game;
+		    	for (; index->logSize < whole && std::fread(record,1,recordSize,log) == recordSize; index->logSize += recordSize) {
+		    		if (decode(record,game)) insert(game);
+		    	}
+		    	std::fclose(log);
+#ifdef TETRIS_MMAP
+		    	// drop a record that was cut off, so the next one starts where it should
+		    	if (whole < size) truncate(logPath.c_str(),static_cast<off_t>(whole));
+#endif
+		    }
+
+		    void close() {
+#ifdef TETRIS_MMAP
+		    	if (index != nullptr && index != local.get()) munmap(index,sizeof(HistoryIndex));
+		    	if (indexFile >= 0) { ::close(indexFile); indexFile = -1; }
+#endif
+		    	index = nullptr; local.reset();
+		    }
+
+		    inline bool isOpen() const { return this->index != nullptr; }
+
+		    // adds a game to the end of the log and to the index. Returns false if it couldn't be stored
+		    bool add(const GameRecord& game) {
+		    	TRACE_SCOPE("History::add");
+		    	if (index == nullptr) return false;
+		    	unsigned char record[recordSize];
+		    	encode(game,record);
+		    	std::FILE* log = std::fopen(logPath.c_str(),"ab");
+		    	if (log == nullptr) return false;
+		    	bool written = std::fwrite(record,1,recordSize,log) == recordSize;
+		    	written = (std::fclose(log) == 0) && written;
+		    	if (!written) return false;
+		    	insert(game);
+		    	index->logSize += recordSize;
+		    	return true;
+		    }
+
+		    // getter methods
+		    inline std::uint64_t getGames() const { return (index == nullptr) ? 0 : index->games; }
+		    // how many of the best games of a level are kept, and one of them (0 is the best)
+		    inline int getTopCount(const int& level) const {
+		    	return (index == nullptr || level < 0 || level >= HistoryIndex::levels) ? 0 : static_cast<int>(index->topCounts[level]);
+		    }
+		    inline const GameRecord& getTop(const int& level,const int& i) const { return index->top[level][i]; }
+		    // how many of the latest games are kept, and one of them (0 is the latest)
+		    inline int getRecentCount() const { return (index == nullptr) ? 0 : static_cast<int>(index->recentCounts); }
+		    inline const GameRecord& getRecent(const int& i) const {
+		    	return index->recent[(index->recentNext+HistoryIndex::recentCount-1-i)%HistoryIndex::recentCount];
+		    }
+
+		    // the score a percentage of games scored less than, give or take 1/16 of it
+		    std::uint32_t percentile(const double& percent) const {
+		    	if (getGames() == 0) return 0;
+		    	std::uint64_t wanted = static_cast<std::uint64_t>(percent/100*index->games);
+		    	if (wanted >= index->games) wanted = index->games-1;
+		    	std::uint64_t counted = 0;
+		    	for (int bucket = 0; bucket < HistoryIndex::buckets; ++bucket) {
+		    		counted += index->histogram[bucket];
+		    		if (counted > wanted) return HistoryIndex::lowestOf(bucket);
+		    	}
+		    	return 0;
+		    }
+	};
+
+	// every game played by the user
+	History gameHistory;
+
+} /* end of namespace tetris */
+//=================================================================================================================================//
+#endif
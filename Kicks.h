@@ -0,0 +1,175 @@
+#ifndef KICKS_H
+#define KICKS_H
+//=================================================================================================================================//
+// needed header files
+#include <cstdint>
+#include "Pieces.h"
+//=================================================================================================================================//
+
+// namespace to contain specific assets used during gameplay
+namespace tetris
+{
+	// how far a turned tetromino is pushed to make it fit, in rows (down) and columns (right)
+	struct Kick {
+		std::int8_t row,column;
+	};
+
+	// the most positions tried for one turn
+	constexpr int maxKicks = 5;
+
+	// the positions to try when a kind of tetromino turns from one state to another, in the order they are
+	// tried. The first one that fits is taken and the tetromino stays as it was if none of them fit
+	struct KickTable {
+		std::uint8_t counts[7][4][4] = {};
+		Kick kicks[7][4][4][maxKicks] = {};
+
+		// the tests of a turn and how many there are
+		inline const Kick* get(const Type& type,const State& from,const State& to) const {
+			return kicks[static_cast<int>(type)-1][static_cast<int>(from)][static_cast<int>(to)];
+		}
+		inline int count(const Type& type,const State& from,const State& to) const {
+			return counts[static_cast<int>(type)-1][static_cast<int>(from)][static_cast<int>(to)];
+		}
+	};
+
+	// the kicks the game always had: a turned tetromino that overlaps something is pushed one or two
+	// rows or columns away from it. Indexed by kind and the state turned to, clockwise
+	struct ClassicKicks {
+		std::uint8_t count;
+		Kick kicks[3];
+	};
+	constexpr ClassicKicks classicKickData[7][4] = {
+		// chord
+		{{3,{{0,1},{0,-1},{0,-2}}},{3,{{1,0},{-1,0},{-2,0}}},{3,{{0,-1},{0,1},{0,2}}},{3,{{-1,0},{1,0},{2,0}}}},
+		// square
+		{{0,{}},{0,{}},{0,{}},{0,{}}},
+		// T block
+		{{1,{{0,1}}},{1,{{1,0}}},{1,{{0,-1}}},{1,{{-1,0}}}},
+		// L block
+		{{2,{{0,-1},{0,1}}},{2,{{-1,0},{1,0}}},{2,{{0,1},{0,-1}}},{2,{{1,0},{-1,0}}}},
+		// reversed L block
+		{{2,{{0,1},{0,-1}}},{2,{{1,0},{-1,0}}},{2,{{0,-1},{0,1}}},{2,{{-1,0},{1,0}}}},
+		// Z block
+		{{2,{{0,1},{0,-1}}},{2,{{1,0},{-1,0}}},{2,{{0,-1},{0,1}}},{2,{{-1,0},{1,0}}}},
+		// reversed Z block
+		{{2,{{0,1},{0,2}}},{2,{{1,0},{2,0}}},{2,{{0,-1},{0,-2}}},{2,{{-1,0},{-2,0}}}}
+	};
+
+	// builds the classic table. A turn tries where it lands first, then the old pushes. Turning
+	// anticlockwise undoes the clockwise pushes of the opposite turn
+	constexpr KickTable classicKicks() {
+		KickTable table;
+		for (int t = 0; t < 7; ++t) {
+			for (int from = 0; from < 4; ++from) {
+				for (int to = 0; to < 4; ++to) {
+					Kick* kicks = table.kicks[t][from][to];
+					int count = 1;
+					if (to == (from+1)%4) {
+						const ClassicKicks& data = classicKickData[t][to];
+						for (int k = 0; k < data.count; ++k) kicks[count++] = data.kicks[k];
+					} else if (from == (to+1)%4) {
+						const ClassicKicks& data = classicKickData[t][from];
+						for (int k = 0; k < data.count; ++k) kicks[count++] = Kick{static_cast<std::int8_t>(-data.kicks[k].row),static_cast<std::int8_t>(-data.kicks[k].column)};
+					}
+					table.counts[t][from][to] = static_cast<std::uint8_t>(count);
+				}
+			}
+		}
+		return table;
+	}
+
+	// the Super Rotation System: the shape of every kind of tetromino when it spawns, on the square grid it
+	// turns around in. Indexed by Type, where the chord is the I, the reversed L is the J and the reversed Z is the S
+	struct SrsShape {
+		std::int8_t size;
+		std::int8_t cells[4][2];
+	};
+	constexpr SrsShape srsShapes[7] = {
+		{4,{{1,0},{1,1},{1,2},{1,3}}}, {2,{{0,0},{0,1},{1,0},{1,1}}}, {3,{{0,1},{1,0},{1,1},{1,2}}},
+		{3,{{0,2},{1,0},{1,1},{1,2}}}, {3,{{0,0},{1,0},{1,1},{1,2}}}, {3,{{0,0},{0,1},{1,1},{1,2}}},
+		{3,{{0,1},{0,2},{1,0},{1,1}}}
+	};
+
+	// the standard kick tests in (x right, y up), for a clockwise turn out of each state and an anticlockwise
+	// turn out of each state. The I has its own tests, the square has none and the rest share theirs
+	constexpr std::int8_t srsKickData[2][2][4][5][2] = {
+		// J, L, S, T and Z
+		{{{{0,0},{-1,0},{-1,1},{0,-2},{-1,-2}},{{0,0},{1,0},{1,-1},{0,2},{1,2}},{{0,0},{1,0},{1,1},{0,-2},{1,-2}},{{0,0},{-1,0},{-1,-1},{0,2},{-1,2}}},
+		 {{{0,0},{1,0},{1,1},{0,-2},{1,-2}},{{0,0},{1,0},{1,-1},{0,2},{1,2}},{{0,0},{-1,0},{-1,1},{0,-2},{-1,-2}},{{0,0},{-1,0},{-1,-1},{0,2},{-1,2}}}},
+		// I
+		{{{{0,0},{-2,0},{1,0},{-2,-1},{1,2}},{{0,0},{-1,0},{2,0},{-1,2},{2,-1}},{{0,0},{2,0},{-1,0},{2,1},{-1,-2}},{{0,0},{1,0},{-2,0},{1,-2},{-2,1}}},
+		 {{{0,0},{-1,0},{2,0},{-1,2},{2,-1}},{{0,0},{2,0},{-1,0},{2,1},{-1,-2}},{{0,0},{1,0},{-2,0},{1,-2},{-2,1}},{{0,0},{-2,0},{1,0},{-2,-1},{1,2}}}}
+	};
+
+	// a standard shape turned clockwise a number of times on its grid, as an orientation
+	constexpr Orientation srsOrientation(const int& type,const int& turns) {
+		const SrsShape& shape = srsShapes[type];
+		int cells[4][2] = {};
+		for (int i = 0; i < 4; ++i) {
+			int row = shape.cells[i][0],column = shape.cells[i][1];
+			for (int n = 0; n < turns%4; ++n) { int turned = row; row = column; column = shape.size-1-turned; }
+			cells[i][0] = row; cells[i][1] = column;
+		}
+		return orient(cells[0][0],cells[0][1],cells[1][0],cells[1][1],cells[2][0],cells[2][1],cells[3][0],cells[3][1]);
+	}
+
+	// are two orientations the same blocks, give or take a shift of all blocks?
+	constexpr bool sameShape(const Orientation& a,const Orientation& b) {
+		if (a.height != b.height || a.width != b.width) return false;
+		for (int k = 0; k < 4; ++k) if (a.masks[k] != b.masks[k]) return false;
+		return true;
+	}
+
+	// the standard state a kind of tetromino's Up state is, or -1 if it isn't one of them
+	constexpr int srsStateOfUp(const int& type) {
+		for (int s = 0; s < 4; ++s) if (sameShape(orientations[type][0],srsOrientation(type,s))) return s;
+		return -1;
+	}
+
+	// builds the standard table. The game's states don't turn around the same point as the standard ones,
+	// so every test is shifted by the difference between where the two systems put the tetromino
+	constexpr KickTable srsKicks() {
+		KickTable table;
+		for (int t = 0; t < 7; ++t) {
+			int first = srsStateOfUp(t);
+			// shift from the game's blocks of a state to the standard blocks of the same state
+			int shiftRow[4] = {},shiftCol[4] = {};
+			for (int s = 0; s < 4; ++s) {
+				Orientation standard = srsOrientation(t,first+s);
+				shiftRow[s] = standard.top-orientations[t][s].top; shiftCol[s] = standard.left-orientations[t][s].left;
+			}
+			for (int from = 0; from < 4; ++from) {
+				for (int to = 0; to < 4; ++to) {
+					int count = 1;
+					std::int8_t tests[maxKicks][2] = {{0,0}};
+					if (t != 1 && (to == (from+1)%4 || from == (to+1)%4)) {
+						int direction = (to == (from+1)%4) ? 0 : 1;
+						const std::int8_t (*data)[2] = srsKickData[t == 0 ? 1 : 0][direction][(first+from)%4];
+						for (int k = 0; k < maxKicks; ++k) { tests[k][0] = data[k][0]; tests[k][1] = data[k][1]; }
+						count = maxKicks;
+					}
+					for (int k = 0; k < count; ++k) {
+						table.kicks[t][from][to][k] = Kick{static_cast<std::int8_t>(-tests[k][1]+shiftRow[to]-shiftRow[from]),
+						                                  static_cast<std::int8_t>(tests[k][0]+shiftCol[to]-shiftCol[from])};
+					}
+					table.counts[t][from][to] = static_cast<std::uint8_t>(count);
+				}
+			}
+		}
+		return table;
+	}
+
+	// every kind of tetromino has to be one of the standard shapes for the standard kicks to make sense
+	constexpr bool srsShapesMatch() {
+		for (int t = 0; t < 7; ++t) if (srsStateOfUp(t) < 0) return false;
+		return true;
+	}
+	static_assert(srsShapesMatch(),"every tetromino has to match a standard shape");
+
+	// the available kick sets
+	constexpr KickTable classicKickTable = classicKicks();
+	constexpr KickTable srsKickTable = srsKicks();
+
+} /* end of namespace tetris */
+//=================================================================================================================================//
+#endif
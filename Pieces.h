@@ -0,0 +1,193 @@
+#ifndef PIECES_H
+#define PIECES_H
+//=================================================================================================================================//
+// needed header files
+#include <cstdint>
+#include "Board.h"
+//=================================================================================================================================//
+
+// namespace to contain specific assets used during gameplay
+namespace tetris
+{
+	// available kinds of tetrominoes
+    enum class Type : std::uint8_t {
+    	Undefined,Chord,Square,TBlock,LBlock,RLBlock,ZBlock,RZBlock
+    };
+    // the rotation states of a tetromino, in clockwise order
+	enum class State : std::uint8_t {
+		Up,Right,Down,Left
+	};
+
+	// a kind of tetromino in one rotation state: the row and column of each block relative to the
+	// tetromino's origin, and the same blocks as one bitmask per row of their bounding box
+	struct Orientation {
+		std::int8_t cells[4][2];
+		// bounding box of the blocks relative to the origin
+		std::int8_t top,left,height,width;
+		// bit 0 of a mask is the leftmost column of the bounding box
+		std::uint8_t masks[4];
+	};
+
+	// builds an orientation from its blocks, working out the bounding box and the masks at compile time
+	constexpr Orientation orient(int r0,int c0,int r1,int c1,int r2,int c2,int r3,int c3) {
+		const int rows[4] = {r0,r1,r2,r3},columns[4] = {c0,c1,c2,c3};
+		Orientation o = {{{0,0},{0,0},{0,0},{0,0}},0,0,0,0,{0,0,0,0}};
+		int top = r0,left = c0,bottom = r0,right = c0;
+		for (int i = 0; i < 4; ++i) {
+			o.cells[i][0] = static_cast<std::int8_t>(rows[i]); o.cells[i][1] = static_cast<std::int8_t>(columns[i]);
+			if (rows[i] < top) top = rows[i];
+			if (rows[i] > bottom) bottom = rows[i];
+			if (columns[i] < left) left = columns[i];
+			if (columns[i] > right) right = columns[i];
+		}
+		o.top = static_cast<std::int8_t>(top); o.left = static_cast<std::int8_t>(left);
+		o.height = static_cast<std::int8_t>(bottom-top+1); o.width = static_cast<std::int8_t>(right-left+1);
+		for (int i = 0; i < 4; ++i) o.masks[rows[i]-top] = static_cast<std::uint8_t>(o.masks[rows[i]-top] | (1u << (columns[i]-left)));
+		return o;
+	}
+
+	// every kind of tetromino (in the order of Type) in its four rotation states (in the order of State). The
+	// origin doesn't move when a tetromino rotates, so a rotation only changes the state
+	constexpr Orientation orientations[7][4] = {
+		// chord
+		{orient(0,0,0,1,0,2,0,3),orient(-1,1,0,1,1,1,2,1),orient(0,-1,0,0,0,1,0,2),orient(-2,1,-1,1,0,1,1,1)},
+		// square
+		{orient(0,0,0,1,1,0,1,1),orient(0,0,0,1,1,0,1,1),orient(0,0,0,1,1,0,1,1),orient(0,0,0,1,1,0,1,1)},
+		// T block
+		{orient(0,0,0,1,0,2,1,1),orient(-1,1,0,0,0,1,1,1),orient(-1,1,0,0,0,1,0,2),orient(-1,1,0,1,0,2,1,1)},
+		// L block
+		{orient(0,0,0,1,0,2,1,0),orient(-1,0,-1,1,0,1,1,1),orient(-1,2,0,0,0,1,0,2),orient(-1,1,0,1,1,1,1,2)},
+		// reversed L block
+		{orient(0,0,0,1,0,2,1,2),orient(-1,1,0,1,1,0,1,1),orient(-1,0,0,0,0,1,0,2),orient(-1,1,-1,2,0,1,1,1)},
+		// Z block
+		{orient(0,0,0,1,1,1,1,2),orient(-1,1,0,0,0,1,1,0),orient(-1,0,-1,1,0,1,0,2),orient(-1,2,0,1,0,2,1,1)},
+		// reversed Z block
+		{orient(0,0,0,1,1,-1,1,0),orient(-1,-1,0,-1,0,0,1,0),orient(-1,0,-1,1,0,-1,0,0),orient(-1,0,0,0,0,1,1,1)}
+	};
+
+	// the column the origin of each kind of tetromino spawns at. It always spawns Up on the top row
+	constexpr int spawnColumns[7] = {3,4,4,4,4,4,5};
+
+	// is every block of a state where the previous state's block lands when turned 90 degrees clockwise
+	// (a block at row r and column c goes to row c and column -r), give or take a shift of all blocks?
+	constexpr bool isTurnOf(const Orientation& from,const Orientation& to) {
+		int shiftRow = 0,shiftCol = 0;
+		for (int i = 0; i < 4; ++i) {
+			int row = from.cells[i][1],column = -from.cells[i][0];
+			if (i == 0 || row < shiftRow) shiftRow = row;
+			if (i == 0 || column < shiftCol) shiftCol = column;
+		}
+		for (int i = 0; i < 4; ++i) {
+			int row = from.cells[i][1]-shiftRow+to.top,column = -from.cells[i][0]-shiftCol+to.left;
+			bool found = false;
+			for (int j = 0; j < 4; ++j) found = found || (to.cells[j][0] == row && to.cells[j][1] == column);
+			if (!found) return false;
+		}
+		return true;
+	}
+
+	// checks the shape data: four different blocks touching each other, masks that hold exactly those
+	// blocks, and states that follow each other clockwise
+	constexpr bool shapesAreValid() {
+		for (int t = 0; t < 7; ++t) {
+			for (int s = 0; s < 4; ++s) {
+				const Orientation& o = orientations[t][s];
+				int blocks = 0;
+				for (int i = 0; i < 4; ++i) {
+					bool touching = false;
+					for (int j = 0; j < 4; ++j) {
+						int dr = o.cells[i][0]-o.cells[j][0],dc = o.cells[i][1]-o.cells[j][1];
+						if (i != j && dr == 0 && dc == 0) return false;
+						touching = touching || (dr*dr+dc*dc == 1);
+					}
+					if (!touching) return false;
+					for (unsigned mask = o.masks[i]; mask != 0; mask &= mask-1) ++blocks;
+				}
+				if (blocks != 4 || o.height > 4 || o.width > 4) return false;
+				if (!isTurnOf(o,orientations[t][(s+1)%4])) return false;
+			}
+		}
+		return true;
+	}
+	static_assert(shapesAreValid(),"every tetromino needs four touching blocks in four clockwise rotation states");
+
+	// a tetromino as a value: its kind, its rotation state and where its origin is on the matrix
+	struct Piece {
+		Type type;
+		State rotation;
+		std::int16_t x,y; // column and row of the origin
+
+		// the blocks of the tetromino in its current state
+		inline const Orientation& orientation() const { return orientations[static_cast<int>(type)-1][static_cast<int>(rotation)]; }
+
+		// row and column of one of the four blocks
+		inline int row(const int& i) const { return y+orientation().cells[i][0]; }
+		inline int column(const int& i) const { return x+orientation().cells[i][1]; }
+		// the top row of its bounding box
+		inline int top() const { return y+orientation().top; }
+
+		// the same tetromino moved by a number of rows and columns
+		inline Piece moved(const int& rows,const int& columns) const {
+			return Piece{type,rotation,static_cast<std::int16_t>(x+columns),static_cast<std::int16_t>(y+rows)};
+		}
+		// the same tetromino turned 90 degrees clockwise
+		inline Piece turned() const {
+			return Piece{type,static_cast<State>((static_cast<int>(rotation)+1)&3),x,y};
+		}
+
+		// a tetromino of a kind where it spawns
+		static inline Piece spawn(const Type& type) {
+			return Piece{type,State::Up,static_cast<std::int16_t>(spawnColumns[static_cast<int>(type)-1]),0};
+		}
+	};
+
+	// does a tetromino fit on the matrix without overlapping a border or a taken cell?
+	template <int Width,int Height>
+	inline bool fits(const BasicBoard<Width,Height>& board,const Piece& piece) {
+		typedef typename BasicBoard<Width,Height>::Row Row;
+		const Orientation& o = piece.orientation();
+		int row = piece.y+o.top,column = piece.x+o.left;
+		if (column < 0 || column+o.width > Width || row < 0 || row+o.height > Height) return false;
+		for (int k = 0; k < o.height; ++k) {
+			if (board.collides(row+k,static_cast<Row>(Row(o.masks[k]) << (column+1)))) return false;
+		}
+		return true;
+	}
+
+	// how many rows a tetromino can fall before it lands: the fewest empty cells under any of its blocks
+	template <int Width,int Height>
+	inline int dropDistance(const BasicBoard<Width,Height>& board,const Piece& piece) {
+		int distance = Height;
+		for (int i = 0; i < 4; ++i) {
+			int n = board.depth(piece.row(i),piece.column(i));
+			if (n < distance) distance = n;
+		}
+		return distance;
+	}
+
+	// stores a tetromino that has landed in the matrix, each block filled with its kind
+	template <int Width,int Height>
+	inline void place(BasicBoard<Width,Height>& board,const Piece& piece) {
+		for (int i = 0; i < 4; ++i) board.set(piece.row(i),piece.column(i),static_cast<std::uint8_t>(piece.type));
+	}
+
+	// the rows a tetromino that just landed made full, bit i being the tetromino's top row plus i
+	template <int Width,int Height>
+	inline std::uint32_t fullRows(const BasicBoard<Width,Height>& board,const Piece& piece) {
+		std::uint32_t rows = 0;
+		for (int i = 0; i < piece.orientation().height; ++i) if (board.rowIsFull(piece.top()+i)) rows |= std::uint32_t(1u) << i;
+		return rows;
+	}
+
+	// clears the lines formed on the rows of a tetromino that just landed, all of them in one sweep of the
+	// matrix. Returns how many were cleared
+	template <int Width,int Height>
+	inline int clearLines(BasicBoard<Width,Height>& board,const Piece& piece) {
+		std::uint32_t rows = fullRows(board,piece);
+		board.clearRows(piece.top(),rows);
+		return bitCount(rows);
+	}
+
+} /* end of namespace tetris */
+//=================================================================================================================================//
+#endif
@@ -0,0 +1,118 @@
+#ifndef RENDERER_H
+#define RENDERER_H
+//=================================================================================================================================//
+// needed header files
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include "Board.h"
+#include "Escape.h"
+//=================================================================================================================================//
+
+// namespace to contain specific assets used during gameplay
+namespace tetris
+{
+	// a character cell on the screen
+	struct Cell {
+		char glyph;
+		std::uint8_t fg,bg; // text and background color codes
+
+		inline bool operator==(const Cell& other) const { return glyph == other.glyph && fg == other.fg && bg == other.bg; }
+		inline bool operator!=(const Cell& other) const { return !(*this == other); }
+	};
+
+	// keeps what is on the screen (front) and what should be on it (back) and only sends the
+	// cells that differ. Cells that were never drawn on belong to someone else and are never sent
+	class Renderer
+	{
+		public:
+		    // part of the screen covered, starting from row 1 and column 1. It is wide enough for the split screen's
+		    // 8 boards side by side
+		    static constexpr int rows = 34, columns = 192;
+		    static_assert(columns <= 256,"columns are kept in a byte");
+
+		private:
+		    // glyph of a cell nobody draws on and of a cell whose content on the screen is unknown
+		    static constexpr char unmanaged = '\0', unknown = '\1';
+
+		    Cell front[rows][columns], back[rows][columns];
+		    // a bit for every row with a cell that differs from what is on the screen, and the columns between
+		    // which they are, so present() only looks through where something was drawn
+		    std::uint64_t dirty = 0;
+		    std::uint8_t from[rows] = {}, to[rows] = {};
+		    static_assert(rows <= 64,"every row needs a bit of dirty");
+		    // holds the escape sequences and glyphs of a frame
+		    std::string out;
+
+		    // appends the sequence that moves the cursor or sets the color, written straight into a buffer on the stack
+		    inline void moveTo(int row,int column) {
+		    	char sequence[SimpleAssets::escape::longest];
+		    	out.append(sequence,SimpleAssets::escape::writeCursor(sequence,row,column)-sequence);
+		    }
+		    inline void setColor(int fg,int bg) {
+		    	char sequence[SimpleAssets::escape::longest];
+		    	out.append(sequence,SimpleAssets::escape::writeColor(sequence,fg,bg)-sequence);
+		    }
+
+		public:
+		    Renderer() { invalidate(); } /* constructor */
+
+		    // forgets everything: nothing is drawn on and the content of the screen is unknown
+		    void invalidate() {
+		    	for (int r = 0; r < rows; ++r) {
+		    		for (int c = 0; c < columns; ++c) { back[r][c] = Cell{unmanaged,0,0}; front[r][c] = Cell{unknown,0,0}; }
+		    	}
+		    	dirty = 0;
+		    }
+
+		    // draws a glyph at a screen position (1 based like cursor())
+		    inline void put(int row,int column,char glyph,int fg,int bg) {
+		    	if (row < 1 || row > rows || column < 1 || column > columns) return;
+		    	Cell cell{glyph,std::uint8_t(fg),std::uint8_t(bg)};
+		    	int r = row-1,c = column-1;
+		    	back[r][c] = cell;
+		    	if (cell == front[r][c]) return;
+		    	std::uint64_t bit = std::uint64_t(1) << r;
+		    	if (!(dirty & bit)) { dirty |= bit; from[r] = to[r] = std::uint8_t(c); }
+		    	else if (c < from[r]) from[r] = std::uint8_t(c);
+		    	else if (c > to[r]) to[r] = std::uint8_t(c);
+		    }
+
+		    // draws some text starting at a screen position
+		    void text(int row,int column,const std::string& n,int fg,int bg) {
+		    	for (char glyph : n) put(row,column++,glyph,fg,bg);
+		    }
+
+		    // draws the same glyph on a number of cells
+		    void fill(int row,int column,int count,char glyph,int fg,int bg) {
+		    	while (count-- > 0) put(row,column++,glyph,fg,bg);
+		    }
+
+		    // builds the sequences for the cells that changed since the last frame and marks them as sent.
+		    // Returns an empty string when nothing changed
+		    const std::string& present() {
+		    	out.clear();
+		    	// where the terminal cursor is and what color is set after the last emitted glyph
+		    	int cursorRow = -1,cursorCol = -1,fg = -1,bg = -1;
+
+		    	for (; dirty != 0; dirty &= dirty-1) {
+		    		int r = lowestBit(dirty);
+		    		for (int c = from[r]; c <= to[r]; ++c) {
+		    			const Cell& cell = back[r][c];
+		    			if (cell.glyph == unmanaged || cell == front[r][c]) continue;
+
+		    			// only move the cursor when the cell is not right after the last one sent
+		    			if (r != cursorRow || c != cursorCol) moveTo(r+1,c+1);
+		    			if (cell.fg != fg || cell.bg != bg) { setColor(cell.fg,cell.bg); fg = cell.fg; bg = cell.bg; }
+		    			out += cell.glyph;
+
+		    			front[r][c] = cell; cursorRow = r; cursorCol = c+1;
+		    		}
+		    	}
+		    	return out;
+		    }
+	};
+
+} /* end of namespace tetris */
+//=================================================================================================================================//
+#endif
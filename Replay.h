@@ -0,0 +1,148 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+//=================================================================================================================================//
+// needed header files
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "GameEngine.h"
+//=================================================================================================================================//
+
+// namespace to contain specific assets used during gameplay
+namespace tetris
+{
+	// what can happen to a game: the first four are the actions of Action, and gravity is the tetromino
+	// falling a row on its own
+	enum class Input : std::uint8_t {
+		None,Left,Right,Rotate,Drop,Gravity
+	};
+
+	// applies an input to a game
+	inline void apply(GameEngine& engine,const Input& input) {
+		if (input == Input::Gravity) engine.tick();
+		else engine.step(static_cast<Action>(input));
+	}
+
+	// a game as its seed and every input that was applied to it, which is enough to play it again exactly.
+	// A .trp file is laid out as:
+	//     "TRP" and a version byte, the seed (4 bytes, little endian), the randomizer (1 byte), the game level
+	//     (1 byte), the gravity delay in milliseconds (2 bytes, little endian), then every input as the
+	//     milliseconds since the input before it (a varint: 7 bits a byte, the high bit set on every byte but
+	//     the last) and the input
+	class Replay
+	{
+		private:
+		    static constexpr std::uint8_t version = 2;
+
+		    unsigned seed = 0;
+		    Randomizer randomizer = Randomizer::Bag;
+		    std::uint8_t level = 0;
+		    std::uint16_t delay = 0;
+		    // the encoded inputs and when the last one happened
+		    std::vector<std::uint8_t> inputs;
+		    unsigned last = 0;
+
+		    // decodes the input at a position of the encoded inputs and moves past it. Returns false if the bytes
+		    // there aren't an input: cut short, a time too long for 32 bits, or an input that doesn't exist
+		    static bool readInput(const std::vector<std::uint8_t>& inputs,std::size_t& position,unsigned& delta,Input& input) {
+		    	delta = 0;
+		    	for (int shift = 0; ; shift += 7) {
+		    		if (shift > 28 || position >= inputs.size()) return false;
+		    		std::uint8_t byte = inputs[position++];
+		    		delta |= unsigned(byte & 0x7f) << shift;
+		    		if ((byte & 0x80) == 0) break;
+		    	}
+		    	if (position >= inputs.size()) return false;
+		    	input = static_cast<Input>(inputs[position++]);
+		    	return input >= Input::Left && input <= Input::Gravity;
+		    }
+
+		public:
+		    Replay() { inputs.reserve(1 << 16); } /* constructor */
+
+		    // getter methods
+		    inline unsigned getSeed() const { return this->seed; }
+		    inline Randomizer getRandomizer() const { return this->randomizer; }
+		    inline int getLevel() const { return this->level; }
+		    inline unsigned getDelay() const { return this->delay; }
+		    inline std::size_t getSize() const { return this->inputs.size(); }
+
+		    // starts recording a new game
+		    void start(const unsigned& seed,const Randomizer& randomizer,const int& level,const unsigned& delay) {
+		    	this->seed = seed; this->randomizer = randomizer; this->level = static_cast<std::uint8_t>(level); this->delay = static_cast<std::uint16_t>(delay);
+		    	inputs.clear(); last = 0;
+		    }
+
+		    // records an input applied a number of milliseconds after the game started
+		    void record(const unsigned& milliseconds,const Input& input) {
+		    	unsigned delta = (milliseconds > last) ? milliseconds-last : 0;
+		    	last += delta;
+		    	for (; delta >= 0x80; delta >>= 7) inputs.push_back(static_cast<std::uint8_t>(delta | 0x80));
+		    	inputs.push_back(static_cast<std::uint8_t>(delta));
+		    	inputs.push_back(static_cast<std::uint8_t>(input));
+		    }
+
+		    // reads the inputs back in order
+		    class Reader
+		    {
+		    	private:
+		    	    const std::vector<std::uint8_t>& inputs;
+		    	    std::size_t position = 0;
+		    	    unsigned time = 0;
+
+		    	public:
+		    	    Reader(const Replay& replay): inputs(replay.inputs) {} /* constructor */
+
+		    	    // the next input and when it happened. Returns false at the end of the game
+		    	    bool next(unsigned& milliseconds,Input& input) {
+		    	    	unsigned delta = 0;
+		    	    	if (position >= inputs.size() || !readInput(inputs,position,delta,input)) return false;
+		    	    	time += delta; milliseconds = time;
+		    	    	return true;
+		    	    }
+		    };
+
+		    // writes the game to a file, or only to a file that doesn't exist yet unless it may be replaced (errno
+		    // is EEXIST if there was one). Returns false if it couldn't be written
+		    bool save(const std::string& path,const bool& replace = true) const {
+		    	TRACE_SCOPE("Replay::save");
+		    	std::FILE* file = std::fopen(path.c_str(),replace ? "wb" : "wbx");
+		    	if (file == nullptr) return false;
+		    	std::uint8_t header[12] = {'T','R','P',version,
+		    		std::uint8_t(seed),std::uint8_t(seed >> 8),std::uint8_t(seed >> 16),std::uint8_t(seed >> 24),
+		    		std::uint8_t(randomizer),level,std::uint8_t(delay),std::uint8_t(delay >> 8)};
+		    	bool written = std::fwrite(header,1,sizeof(header),file) == sizeof(header)
+		    	            && std::fwrite(inputs.data(),1,inputs.size(),file) == inputs.size();
+		    	return (std::fclose(file) == 0) && written;
+		    }
+
+		    // reads a game from a file. Returns false if it isn't a replay this version can play or any of its
+		    // inputs can't be read
+		    bool load(const std::string& path) {
+		    	std::FILE* file = std::fopen(path.c_str(),"rb");
+		    	if (file == nullptr) return false;
+		    	std::uint8_t header[12];
+		    	bool valid = std::fread(header,1,sizeof(header),file) == sizeof(header)
+		    	          && header[0] == 'T' && header[1] == 'R' && header[2] == 'P' && header[3] == version
+		    	          && header[8] <= std::uint8_t(Randomizer::Uniform);
+		    	if (valid) {
+		    		seed = header[4] | (unsigned(header[5]) << 8) | (unsigned(header[6]) << 16) | (unsigned(header[7]) << 24);
+		    		randomizer = static_cast<Randomizer>(header[8]);
+		    		level = header[9]; delay = std::uint16_t(header[10] | (header[11] << 8));
+		    		inputs.clear(); last = 0;
+		    		std::uint8_t buffer[4096];
+		    		for (std::size_t n; (n = std::fread(buffer,1,sizeof(buffer),file)) > 0; ) inputs.insert(inputs.end(),buffer,buffer+n);
+		    		// every input has to decode, so a file that was cut short or is corrupt is turned down here
+		    		unsigned delta; Input input;
+		    		for (std::size_t position = 0; valid && position < inputs.size(); ) valid = readInput(inputs,position,delta,input);
+		    		if (!valid) inputs.clear();
+		    	}
+		    	std::fclose(file);
+		    	return valid;
+		    }
+	};
+
+} /* end of namespace tetris */
+//=================================================================================================================================//
+#endif
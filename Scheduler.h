@@ -0,0 +1,117 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+//=================================================================================================================================//
+// needed header files
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+//=================================================================================================================================//
+
+// namespace to contain specific assets used during gameplay
+namespace tetris
+{
+	// runs batches of independent tasks on every core. Every worker has its own queue which it takes tasks from
+	// the front of, and a worker whose queue is empty steals from the back of the others' queues, so a worker that
+	// drew short tasks doesn't sit idle while another still has a queue of long ones
+	class Scheduler
+	{
+		private:
+		    struct Queue {
+		    	std::mutex lock;
+		    	std::deque<std::size_t> tasks;
+		    };
+
+		    std::vector<std::thread> threads;
+		    std::unique_ptr<Queue[]> queues;
+		    unsigned workers = 0;
+
+		    // what every task of the current batch runs, given the task's index
+		    std::function<void(std::size_t)> job;
+		    // tasks of the current batch that haven't finished
+		    std::atomic<std::size_t> remaining{0};
+		    // tasks taken from another worker's queue, over every batch
+		    std::atomic<unsigned long long> steals{0};
+
+		    // wakes the workers up for a new batch or to stop, and the caller up when a batch is done
+		    std::mutex lock;
+		    std::condition_variable wake,done;
+		    unsigned long long batch = 0;
+		    bool stopping = false;
+
+		    // takes a task from a worker's own queue, or steals one from another worker's
+		    bool take(const unsigned& self,std::size_t& task) {
+		    	{
+		    		std::lock_guard<std::mutex> guard(queues[self].lock);
+		    		if (!queues[self].tasks.empty()) { task = queues[self].tasks.front(); queues[self].tasks.pop_front(); return true; }
+		    	}
+		    	for (unsigned i = 1; i < workers; ++i) {
+		    		Queue& victim = queues[(self+i)%workers];
+		    		std::lock_guard<std::mutex> guard(victim.lock);
+		    		if (!victim.tasks.empty()) { task = victim.tasks.back(); victim.tasks.pop_back(); ++steals; return true; }
+		    	}
+		    	return false;
+		    }
+
+		    // what every worker thread does until the scheduler is destroyed
+		    void work(const unsigned& self) {
+		    	unsigned long long seen = 0;
+		    	while (true) {
+		    		{
+		    			std::unique_lock<std::mutex> guard(lock);
+		    			wake.wait(guard,[&]() { return stopping || batch != seen; });
+		    			if (stopping) return;
+		    			seen = batch;
+		    		}
+		    		std::size_t task;
+		    		while (take(self,task)) {
+		    			job(task);
+		    			if (--remaining == 0) { std::lock_guard<std::mutex> guard(lock); done.notify_all(); }
+		    		}
+		    	}
+		    }
+
+		public:
+		    Scheduler(unsigned workers = std::thread::hardware_concurrency()) { /* constructor */
+		    	this->workers = (workers == 0) ? 1 : workers;
+		    	queues.reset(new Queue[this->workers]);
+		    	for (unsigned i = 0; i < this->workers; ++i) threads.emplace_back(&Scheduler::work,this,i);
+		    }
+		    ~Scheduler() { /* destructor */
+		    	{ std::lock_guard<std::mutex> guard(lock); stopping = true; }
+		    	wake.notify_all();
+		    	for (std::thread& thread : threads) thread.join();
+		    }
+		    Scheduler(const Scheduler&) = delete;
+		    Scheduler& operator=(const Scheduler&) = delete;
+
+		    // getter methods
+		    inline unsigned getWorkers() const { return this->workers; }
+		    inline unsigned long long getSteals() const { return this->steals; }
+
+		    // runs task(0) to task(count-1) across the workers and returns once they have all finished. The
+		    // tasks are dealt out in turn, so neighbouring tasks start on different workers
+		    void run(const std::size_t& count,const std::function<void(std::size_t)>& task) {
+		    	if (count == 0) return;
+		    	job = task;
+		    	remaining = count;
+		    	for (std::size_t i = 0; i < count; ++i) {
+		    		Queue& queue = queues[i%workers];
+		    		std::lock_guard<std::mutex> guard(queue.lock);
+		    		queue.tasks.push_back(i);
+		    	}
+		    	std::unique_lock<std::mutex> guard(lock);
+		    	++batch;
+		    	wake.notify_all();
+		    	done.wait(guard,[&]() { return remaining == 0; });
+		    }
+	};
+
+} /* end of namespace tetris */
+//=================================================================================================================================//
+#endif
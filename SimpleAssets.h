@@ -4,55 +4,39 @@
 // needed header files
 #include <iostream>
 #include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#if __has_include(<conio.h>)
 #include <conio.h>
+#else
+#include "Console.h" /* getch() and kbhit() through termios */
+#endif
 #include <fstream>
 #include <random>
 #include <string>
 #include <sys/stat.h>
 #include <vector>
+#include "Escape.h"
+#include "Frame.h"
+#include "Trace.h"
 #if defined(__linux__)||defined(__linux)||defined(linux)
 #include <unistd.h>
 #define Sleep(milliseconds) (usleep(milliseconds*1000))
-#define createDirectory(n) (mkdir(n,'-p'))
 #else
 #include <windows.h> /* prototype for Sleep() */
-#define createDirectory(n) (n)
 #endif
 //==================================================================================================================================//
 
-// prototypes
-void userOption(const int& = 0);
-void runGame();
-void startNewGame();
-
 // namespace to contain all the tools the game needs
 namespace SimpleAssets
 {
-	// stores available text color
-	enum textColor { 
-	    red = 31,green = 32,yellow = 33,blue = 34,pink = 35,cyan = 36, normal = 39,darkgray = 90,white = 97
-	};
-	
-	// stores available background color
-	enum bcgColor { 
-	    Black = 40, Red = 41,Green = 42,Yellow = 43,Blue = 44,Pink = 45,Cyan = 46,Normal = 49,DarkGray = 100,White = 107
-	};
-	
 	// store available interfaces
     enum class Page {
         Undefined,Menu,NewGame,Difficulty,Score,Instructions,Settings
     };
 	
-	// sets cursor position
-	inline std::string cursor(const int& row = 35, const int& column = 1) {
-		return ("\033["+std::to_string(row)+";"+std::to_string(column)+"H");
-	}
-	
-	// sets text and background color
-	inline std::string color(const textColor& c = normal,const bcgColor& b = Normal) {
-		return ("\033[1;"+std::to_string(c)+";"+std::to_string(b)+"m");
-	}
-	
 	// positions an item in a way that it moves inwards when the length increases
 	inline std::string space(unsigned var,unsigned n) {
 		return std::string(n-std::to_string(var).length(),' ');
@@ -63,105 +47,151 @@ namespace SimpleAssets
 		return (cursor(row,(colEnd-(colEnd-colBegin)/2)-(n.length()-color(clr).length())/2)+n);
 	}
 	
-	// class that handles how the gamedata is processed
+	// class that handles how the gamedata is processed. The scores are stored in tetris.dat as one binary record
+	// of a fixed size, laid out as:
+	//     "TSCO", the version (2 bytes) and the size of the record (2 bytes), the highest lines, the total lines
+	//     cleared, the games played and the highest score (4 bytes each), 4 spare bytes, then a checksum
+	//     (FNV-1a) of every byte before it. Every number is little endian
+	// the record is written to a temporary file that then replaces tetris.dat, so a game that stops while the
+	// scores are saved leaves either the old scores or the new ones. Older versions stored the scores as text,
+	// which is imported the first time this version runs
 	class Data
 	{
 		private:
-		    // for manipulating the game's data in file
-		    std::fstream gameData;
-		    std::string data[5];
+		    static constexpr std::uint16_t version = 1;
+		    static constexpr std::size_t recordSize = 32;
 		    
-		    // where to store the game data file on the device
-		    std::string path = "/storage/emulated/0/Android/data/";
-		    char *directory = "/storage/emulated/0/Android/data/com.nunugames.tg/";
-		    std::string folder = directory;
+		    // where older versions stored the game data file on the device
+		    const char* androidFolder = "/storage/emulated/0/Android/data/com.nunugames.tg/";
+		    // where to store the game data file, ending with a '/' unless it is the current folder
+		    std::string folder = "";
+		    // the folder was chosen with setFolder(), so the default folder isn't used
+		    bool folderIsSet = false;
 		    
 		    // user data to store
-		    unsigned highestLines = 0, linesCleared = 0;
+		    unsigned highestLines = 0;
 	        unsigned totalLinesCleared = 0,highestScore = 0,gamesPlayed = 0;
-	        unsigned score = 0;
 	        bool hasData = false;
 	        
+	        static inline void put(unsigned char* bytes,const std::uint32_t& value) {
+	        	for (int i = 0; i < 4; ++i) bytes[i] = static_cast<unsigned char>(value >> (8*i));
+	        }
+	        static inline std::uint32_t get(const unsigned char* bytes) {
+	        	return bytes[0] | (std::uint32_t(bytes[1]) << 8) | (std::uint32_t(bytes[2]) << 16) | (std::uint32_t(bytes[3]) << 24);
+	        }
+	        static std::uint32_t checksum(const unsigned char* bytes,const std::size_t& size) {
+	        	std::uint32_t hash = 2166136261u;
+	        	for (std::size_t i = 0; i < size; ++i) hash = (hash ^ bytes[i])*16777619u;
+	        	return hash;
+	        }
+	        
+	        // the folder the scores are stored in when none is set: $XDG_DATA_HOME/tetris, or ~/.local/share/tetris
+	        // if it isn't set. Other systems use the current folder
+	        static std::string defaultFolder() {
+#if defined(__linux__)||defined(__linux)||defined(linux)
+	        	const char* data = std::getenv("XDG_DATA_HOME");
+	        	if (data != nullptr && data[0] == '/') return std::string(data)+"/tetris/";
+	        	const char* home = std::getenv("HOME");
+	        	if (home != nullptr && home[0] != '\0') return std::string(home)+"/.local/share/tetris/";
+#endif
+	        	return "";
+	        }
+	        
+	        // creates a folder along with every folder above it that isn't there
+	        static void createFolders(const std::string& folder) {
+#if defined(__linux__)||defined(__linux)||defined(linux)
+	        	for (std::size_t end = folder.find('/',1); end != std::string::npos; end = folder.find('/',end+1)) {
+	        		mkdir(folder.substr(0,end).c_str(),0755);
+	        	}
+#endif
+	        }
+	        
+	        // reads the scores from a record. Returns false, leaving the scores alone, if the file isn't a record
+	        // this version wrote or it has been damaged
+	        bool readRecord(const std::string& file) {
+	        	unsigned char record[recordSize];
+	        	std::FILE* in = std::fopen(file.c_str(),"rb");
+	        	if (in == nullptr) return false;
+	        	bool read = std::fread(record,1,recordSize,in) == recordSize;
+	        	std::fclose(in);
+	        	if (!read || std::memcmp(record,"TSCO",4) != 0 || (record[4] | (record[5] << 8)) != version
+	        	 || (record[6] | (record[7] << 8)) != recordSize || get(record+28) != checksum(record,28)) return false;
+	        	highestLines = get(record+8); totalLinesCleared = get(record+12);
+	        	gamesPlayed = get(record+16); highestScore = get(record+20);
+	        	return true;
+	        }
+	        
 	    public:
 	        Data() {} /* constructor */
 	        
 	        // setter methods
+	        inline void setFolder(const std::string& folder) { this->folder = folder; folderIsSet = true; }
 	        inline void setHighestLines(const unsigned& n) { highestLines = n; }
 	        inline void setHighestScore(const unsigned& n) { highestScore = n; }
-	        inline void incrementLinesCleared() { linesCleared++; }
-	        inline void incrementTotalLinesCleared() { totalLinesCleared += linesCleared; }
+	        inline void incrementTotalLinesCleared(const unsigned& n) { totalLinesCleared += n; }
 	        inline void incrementGamesPlayed() { gamesPlayed++; }
-	        inline void incrementScore() { score += (3 * this->linesCleared); }
-	        inline void setDefaultGameScores() { linesCleared = score = 0; }
 	        
 	        // getter methods
 	        inline unsigned getHighestLines() { return this->highestLines; }
-	        inline unsigned getLinesCleared() { return this->linesCleared; }
 	        inline unsigned getTotalLinesCleared() { return this->totalLinesCleared; }
 	        inline unsigned getGamesPlayed() { return this->gamesPlayed; }
 	        inline unsigned getHighestScore() { return this->highestScore; }
-	        inline unsigned getScore() { return this->score; }
 	        inline bool getHasData() { return this->hasData; }
+	        inline const std::string& getFolder() { return this->folder; }
+	        
+	        // stores game data in a file. Returns false if the scores couldn't be stored, in which case the file
+	        // still holds the scores stored before
+	        bool createGameData() {
+	        	TRACE_SCOPE("Data::createGameData");
+	        	unsigned char record[recordSize] = {'T','S','C','O',version & 0xff,version >> 8,recordSize,0};
+	        	put(record+8,highestLines); put(record+12,totalLinesCleared);
+	        	put(record+16,gamesPlayed); put(record+20,highestScore);
+	        	put(record+28,checksum(record,28));
+	        	
+	        	// write the record to a file of its own, make sure it is on the disk, then put it in place of the old one
+	        	std::string file = folder+"tetris.dat",temporary = file+".tmp";
+	        	std::FILE* out = std::fopen(temporary.c_str(),"wb");
+	        	if (out == nullptr) return false;
+	        	bool written = std::fwrite(record,1,recordSize,out) == recordSize && std::fflush(out) == 0;
+#if defined(__linux__)||defined(__linux)||defined(linux)
+	        	written = written && fsync(fileno(out)) == 0;
+#else
+	        	std::remove(file.c_str()); /* rename() doesn't replace a file here */
+#endif
+	        	written = (std::fclose(out) == 0) && written;
+	        	if (!written || std::rename(temporary.c_str(),file.c_str()) != 0) { std::remove(temporary.c_str()); return false; }
+	        	return true;
+	        }
 	        
-	        // stores game data in a file
-	        void createGameData() {
-	        	// open the file to save the scores
-	        	gameData.open(folder+"tetris.dat",std::ios::out);
-	            // write the scores to the file
-	            gameData << "[Tetris scores]\n";
-	            gameData << "Highest lines in one game :   data[ " << highestLines << " ]\n";
-	            gameData << "Total lines cleared :"+std::string(9,' ') << "data[ " << totalLinesCleared << " ]\n";
-	            gameData << "Games played :"+std::string(16,' ') << "data[ " << gamesPlayed << " ]\n";
-	            gameData << "Highest score :"+std::string(15,' ') << "data[ " << highestScore << " ]";
-	            
-	            // close the file
-	            gameData.close();
-	            // reopen the file for reading
-	            gameData.open(folder+"tetris.dat",std::ios::in);
-	            // store the details written in the file to data
-	            for (auto& val : data) {
-	            	std::getline(gameData,val);
-	            }
-	            gameData.close();
+	        // reads the scores from a file older versions wrote as text. Returns false if the file isn't one
+	        bool importText(const std::string& file) {
+	        	std::ifstream text(file);
+	        	std::string line;
+	        	if (!std::getline(text,line) || line.compare(0,15,"[Tetris scores]") != 0) return false;
+	        	unsigned values[4];
+	        	for (unsigned& value : values) {
+	        		std::size_t at;
+	        		if (!std::getline(text,line) || (at = line.find("data[")) == std::string::npos) return false;
+	        		value = static_cast<unsigned>(std::strtoul(line.c_str()+at+5,nullptr,10));
+	        	}
+	        	highestLines = values[0]; totalLinesCleared = values[1]; gamesPlayed = values[2]; highestScore = values[3];
+	        	return true;
 	        }
 	        
 	        // retrieves the current game data from the file it is stored
 	        void retrieveGameData() {
-	        	// check if the path exist on the device
-	        	gameData.open(path+".test",std::ios::out);
-	        	gameData.close();
-	        	if (!gameData.fail()) {
-	        		// if the path exists then open the game file to retrieve the scores
-	                gameData.open(folder+"tetris.dat",std::ios::in);
-	            	if (gameData.fail()) {
-	            		// if the game file doesn't already exist then it means the folder
-	            		// doesn't exist, so create the folder then create a game data file
-	        	        createDirectory(directory); createGameData();
-	            	}
-	            // if the path doesn't exist on the device then set file storage to default
-	            // and create a new game data file
-	            } else {
-	        		folder = ""; createGameData();
-	        	}
-	        	// retrieve the saved scores and store in data
-	        	for (auto& val : data) {
-	        	    std::getline(gameData,val);
-	            }
-	            
-	            // close the file if it is still open
-	            if (gameData.is_open()) gameData.close();
-	            
-	        	// the exception may occur if user messes with the file to negate how data
-	        	// is passed to the variables below in the try statement
-	        	try {
-	        		// pass the scores from data to their respective holders
-	            	highestLines = std::stoi(data[1].substr(data[1].find("data")+6)); totalLinesCleared = std::stoi(data[2].substr(data[2].find("data")+6));
-	            	gamesPlayed = std::stoi(data[3].substr(data[3].find("data")+6)); highestScore = std::stoi(data[4].substr(data[4].find("data")+6));
-	            // if the scores can't be gotten due to the above reason then keep overwriting
-	            // user data with default data when the game runs
-	        	} catch (const std::invalid_argument& ex) {
-	        	    // creating data before retrieving successfully resets game data to default values
-	        	    createGameData();
+	        	TRACE_SCOPE("Data::retrieveGameData");
+	        	if (!folderIsSet) folder = defaultFolder();
+	        	createFolders(folder);
+	        	
+	        	std::string file = folder+"tetris.dat";
+	        	if (!readRecord(file)) {
+	        		// the scores of an older version, in the same file or where that version kept them. If there
+	        		// are none the scores start from nothing
+	        		bool imported = importText(file);
+	        		if (!imported && !folderIsSet) imported = importText(std::string(androidFolder)+"tetris.dat") || importText("tetris.dat");
+	        		if (!imported) { highestLines = 0; totalLinesCleared = 0; highestScore = 0; gamesPlayed = 0; }
+	        		createGameData();
 	        	}
 	        	hasData = true;
 	        }
@@ -204,20 +234,20 @@ namespace SimpleAssets
             // updates the position of the selector
             void indicateOption(const std::string& option = "",const int& option_col = 0) {
                 // display the selector
-                std::cout << cursor(row,col) << color(green) << ">[";
-                std::cout << cursor(row,col+2) << color(white,Red) << std::string(width,' ');
-                std::cout << cursor(row,col+width) << color(green) << "]<";
+                frame << cursor(row,col) << color(green) << ">[";
+                frame << cursor(row,col+2) << color(white,Red); frame.repeat(width,' ');
+                frame << cursor(row,col+width) << color(green) << "]<";
                     
                 // highlight the option
-                std::cout << cursor(row,option_col) << color(white,Red) << option << std::flush;
+                frame << cursor(row,option_col) << color(white,Red) << option;
                 tempOption = option; tempCol = option_col;
             }
         
             // erases the former position of the selector
         	void erase() {
     		    // erase the previous position of the selector
-                std::cout << cursor(row,col) << color(normal) << std::string(width+2,' ');
-                std::cout << cursor(row,tempCol) << color(cyan) << tempOption;
+                frame << cursor(row,col) << color(normal); frame.repeat(width+2,' ');
+                frame << cursor(row,tempCol) << color(cyan) << tempOption;
             }
         	
             // moves the selector to another row
@@ -270,6 +300,11 @@ namespace SimpleAssets
     	    // where the cursor is placed in a certain screen page and the color
     	    int cursorDefaultRow = 35,cursorDefaultCol = 1;
     	    textColor cursorDefaultColor = normal;
+    	    // put the cursor back after everything displayed. Pages that are kept put it back once at the end
+    	    bool restoring = true;
+    	    
+    	    // what clear() prints, made the first time it is needed
+    	    std::string blank;
     	    
     	// accessible from anywhere    
     	public:
@@ -286,7 +321,8 @@ namespace SimpleAssets
             
     	    // get user input commands
             inline void setCommand() {
-    	        std::cout << cursor() << std::flush;
+    	        // everything printed since the last input is sent in one frame
+    	        frame << cursor(); frame.flush();
     	
             	// wait for input
     	        this->command = getch();
@@ -306,17 +342,31 @@ namespace SimpleAssets
     	    inline const std::string *getOptions(const int& index) { return options[index]; }
     	    inline const int *getOptionsCols(const int& index) { return options_cols[index]; }
     	    
+    	    // what erasing the screen but not the borders prints
+    	    std::string blankScreen() const {
+    	    	std::string n = color();
+    	    	for (int y = this->dy; y >= this->startY; y--) n += cursor(y,this->startX)+std::string(this->dx,' ');
+    	    	return n+cursor();
+    	    }
+    	    
     	    // erases the screen but not the borders
     	    void clear() {
-    	    	for (int y = this->dy; y >= this->startY; y--) {
-    	    		std::cout << cursor(y,this->startX) << color() << std::string(this->dx,' ') << cursor() << std::flush;
-    	    	}
+    	    	if (blank.empty()) blank = blankScreen();
+    	    	frame << blank;
+    	    }
+    	    
+    	    // sets whether display() puts the cursor back after every call, and puts it back now
+    	    inline void setRestoring(const bool& value) {
+    	    	restoring = value;
+    	    	frame << cursor(cursorDefaultRow,cursorDefaultCol) << color(cursorDefaultColor);
     	    }
     	    
     	    // display to screen
     	    void display(const std::string& n = "",const int& r = 34,const int& c = 4,const textColor& clr = blue,const bcgColor& bcg = Normal) {
+    	    	TRACE_SCOPE("Screen::display");
     	    	// set position to print to and print to the screen
-    	    	std::cout << cursor(r,c) << color(clr,bcg) << n << cursor(cursorDefaultRow,cursorDefaultCol) << color(cursorDefaultColor);
+    	    	frame << cursor(r,c) << color(clr,bcg) << n;
+    	    	if (restoring) frame << cursor(cursorDefaultRow,cursorDefaultCol) << color(cursorDefaultColor);
     	    }
             
             // creates a box container
@@ -333,32 +383,9 @@ namespace SimpleAssets
             	display(std::string(width-2,bborder),start_row+1,start_col+1,clr);
             }
         	
-            void initialize_selection() { /* this highlights and processes a selectable option */
-            	// highlight the option
-            	if (page == Page::Menu || page == Page::Difficulty) {
-            	    selector->indicateOption(options[pageIndex][selector->getCount()],options_cols[pageIndex][selector->getCount()]);
-            	}
-                // wait for user input
-                setCommand();
-               
-                // only checks if the user wants to go back
-                if (page != Page::Menu) userOption();
-                
-            	if (page == Page::Menu || page == Page::Difficulty) {
-            		if (command == '8' || command == '2') {
-            		    // erase the previous position of the selector
-            		    selector->erase();
-            			
-            			// change the selector's position
-                        selector->scroll(command);
-            		
-            		// selected an option
-            	    } else if (command == '5') {
-            	    	// process the option the user selected
-            	    	userOption(selector->getRow());
-            	    }
-            	}
-            }
+            // highlights and processes a selectable option. It leads to every page and to the game, so it is
+            // defined in GameUtility.h with them
+            void initialize_selection();
     }; /* end of class Screen */
 	
 	// create a Screen object
@@ -388,6 +415,8 @@ namespace SimpleAssets
 			case 23: return Level::level5; break;
 			case 26: return Level::level6; break;
 		}
+		// the selector is always on a level, but if it isn't the level stays as it was
+		return level;
 	}
 	
 	// has a level been defined?
@@ -0,0 +1,111 @@
+#ifndef SPLIT_SCREEN_H
+#define SPLIT_SCREEN_H
+//=================================================================================================================================//
+// needed header files
+#include <chrono>
+#include <string>
+#include "GameView.h"
+#include "EventLoop.h"
+//=================================================================================================================================//
+
+// namespace to contain specific assets used during gameplay
+namespace tetris
+{
+	// the most boards the split screen shows side by side, one gravity timer each
+	const int maxBoards = EventLoop::maxTimers;
+
+	// draws one board of the split screen at its own place on the screen. Every board draws into the same
+	// renderer, so a frame of the whole screen is still one write. A board takes these rows:
+	//     2 its name, 3 and 4 its score and lines, 6 and 7 the next shape, 9 to 30 the matrix and its borders,
+	//     32 how its game went
+	class BoardView : public GameObserver
+	{
+		public:
+		    // screen row of the matrix's top row and the columns every board takes, with a gap after it
+		    static constexpr int top = 10, width = 24;
+
+		private:
+		    // screen column of the board's left border
+		    int left;
+		    std::string name;
+
+		    // draws a score under the name
+		    void drawCount(const int& row,const std::string& label,const unsigned& value) {
+		    	std::string number = std::to_string(value);
+		    	renderer.fill(row,left+1,20,' ',normal,Normal);
+		    	renderer.text(row,left+1,label,pink,Normal);
+		    	renderer.text(row,left+1+label.length(),number,green,Normal);
+		    }
+
+		    void drawScores(const GameEngine& engine) {
+		    	drawCount(top-7,"Score: ",engine.getScore());
+		    	drawCount(top-6,"Lines: ",engine.getLines());
+		    }
+
+		    // draws the next shape above where it will spawn
+		    void drawPreview(const GameEngine& engine) {
+		    	for (int i = top-4; i <= top-3; ++i) renderer.fill(i,left+1,20,' ',normal,Normal);
+		    	Piece preview = engine.getPreview();
+		    	for (int i = 0; i < 4; ++i) drawBrick(top-4+preview.row(i),left+1+2*preview.column(i),preview.type);
+		    }
+
+		public:
+		    BoardView(const int& index,const std::string& name): left(2+index*width), name(name) {} /* constructor */
+
+		    // draws everything, for the start of a game
+		    void redraw(const GameEngine& engine) {
+		    	renderer.fill(top-8,left+1,20,' ',normal,Normal);
+		    	renderer.text(top-8,left+11-static_cast<int>(name.length())/2,name,yellow,Normal);
+		    	// the matrix's borders, the way Screen::createContainer draws them
+		    	renderer.fill(top-1,left+1,20,'_',blue,Normal);
+		    	for (int r = top; r < top+Board::height; ++r) { renderer.put(r,left,'|',blue,Normal); renderer.put(r,left+21,'|',blue,Normal); }
+		    	renderer.fill(top+Board::height,left+1,20,'"',blue,Normal);
+		    	showResult("",normal);
+		    	drawScores(engine); drawPreview(engine); drawMatrix(engine,top,left+1);
+		    }
+
+		    // shows how the board's game went under it
+		    void showResult(const std::string& result,const textColor& clr) {
+		    	renderer.fill(top+Board::height+2,left+1,20,' ',normal,Normal);
+		    	renderer.text(top+Board::height+2,left+11-static_cast<int>(result.length())/2,result,clr,Normal);
+		    }
+
+		    void pieceMoved(const GameEngine& engine) { drawMatrix(engine,top,left+1); }
+		    void linesCleared(const GameEngine& engine,int) { drawScores(engine); }
+		    void pieceSpawned(const GameEngine& engine) { drawMatrix(engine,top,left+1); drawPreview(engine); }
+		    void gameOver(const GameEngine&) { showResult("GAME OVER",red); }
+	};
+
+	// a board of the split screen: its game, where it is drawn, and, for a board the bot plays, the keys it is
+	// going to type and when it types the next one
+	struct SplitBoard {
+		GameEngine engine;
+		BoardView view;
+		bool bot;
+		std::string plan;
+		std::size_t typed = 0;
+		std::chrono::steady_clock::time_point nextKey;
+		unsigned pieces = 0;
+
+		SplitBoard(const int& index,const unsigned& seed,const Randomizer& randomizer,const bool& bot,const std::string& name):
+		    engine(seed,randomizer), view(index,name), bot(bot) { /* constructor */
+			engine.setObserver(&view);
+			pieces = engine.getPieces();
+		}
+
+		// applies a key to the board's game. Returns false if it isn't one of the keys that move the tetromino
+		bool press(const char& key) {
+			switch (key) {
+				case '4': engine.step(Action::Left); break;
+				case '6': engine.step(Action::Right); break;
+				case '5': engine.step(Action::Rotate); break;
+				case '0': engine.step(Action::Drop); break;
+				default: return false;
+			}
+			return true;
+		}
+	};
+
+} /* end of namespace tetris */
+//=================================================================================================================================//
+#endif
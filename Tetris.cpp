@@ -1,871 +1,524 @@
 // contains everything the game needs to function
 #include "GameUtility.h"
+#include "GameView.h"
+#include "EventLoop.h"
+#include "Bot.h"
+#include "Replay.h"
+#include "SplitScreen.h"
+#include "Versus.h"
+#include "Broadcast.h"
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <thread>
 // namespace to contain specific assets used during gameplay
 namespace tetris
 {
-	typedef std::string Block;
-	
-	// stores the action the user wants to perform on the game
-	char actionCommand = '\0';
-	bool dropped = false;
-	
-	// available kinds of tetrominoes
-    enum class Type {
-    	Undefined,Chord,Square,TBlock,LBlock,RLBlock,ZBlock,RZBlock
-    };
-    // the state defines the current rotation state of the tetronino
-	enum class State {
-		Undefined,Up,Down,Left,Right
-	};
-	
-	enum class Movement {
-		Undefined,Up,Down,Left,Right
-	};
-	
-	enum class Drop {
-		Normal,Instant
-	};
-	
-	// position of each block that makes up the tetromino
-	struct bit {
-		// coordinates
-		short row,column;
-		
-		// constructors
-		bit() {}
-		bit(short r,short c) : row(r),column(c) {}
-		
-		// operator
-		bool operator==(const bit& coordinate) {
-			return (this->row == coordinate.row && this->column == coordinate.column);
-		}
-	};
-	
-	// array of bit to store the coordinates or positions that are not free
-	std::vector<bit> bitsArray;
-	
-	// array of Block to store a shape and where it's located on the matrix
-	std::vector<Block> blocksArray;
-	
-	State shapeStateInfo = State::Undefined;
-	
-	// stores the kind of movement action being made
-	Movement movementType = Movement::Undefined;
-	Drop dropType = Drop::Normal;
-	
-	// stores previous coordinates of a tetromino
-	short rowBitStorage[4],colBitStorage[4];
-	
-	// determines if a line has been formed somewhere and if the matrix is full, respectively
-	bool lineIsFormed = false,full = false;
-	
-	// different kinds of tetromino will be built with this class
-	class Tetromino
-	{
-		private:
-		    // checks for collision and handles it
-		    bool collision(bool = false),bitSet = false;
-		protected:
-		    // a block has a shape and color
-		    Block brick = Block("[]");
-		    bcgColor brickColor; // color of the tetromino
-		    
-		    // what kind of tetromino
-		    Type shapeType = Type::Undefined;
-		    // stores current rotation state
-		    State shapeState = State::Undefined; 
-		    // coordinates(row and column) of each block that makes up the tetromino
-		    int initialColumn = 22, rbits[4] = {9,0,0,0}, cbits[4] = {initialColumn,0,0,0};
-		    
-		    // set increment to individual bits
-		    void setbits(int,int,int,int,int,int,int,int);
-        public:
-            // set block color 
-            void setBrickColor(const bcgColor& c) { this->brickColor = c; }
-            void setShapeState(const State& value) { this->shapeState = value; }
-            
-            inline void modifyRBit(const int& index,const int& value) { rbits[index] = value; }
-            inline void modifyCBit(const int& index,const int& value) { cbits[index] = value; }
-            inline void modifyRBit(const int& value) { for (int i = 0; i < 4; ++i) rbits[i] += value; }
-            inline void modifyCBit(const int& value) { for (int i = 0; i < 4; ++i) cbits[i] += value; }
-            inline void setBitSet(bool value) { this->bitSet = value; }
-            
-            inline int getrbits(const int& index) const { return this->rbits[index]; }
-            inline int getcbits(const int& index) const { return this->cbits[index]; }
-            inline int getInitialColumn() const { return this->initialColumn; }
-            
-            // erase the previous view of the shape
-            inline void erase() const { for (int i = 0; i < 4; ++i) std::cout << color() << cursor(rbits[i],cbits[i]) << std::string(2,' '); }
-            
-            // movement actions
-            void moveLeft(),moveRight(),turn(),storeCurrentPos(),stayAtCurrentPos();
-            int drop();
-            
-            virtual Block getShape() = 0;
-            virtual Block rotate() = 0;
-	};
-	
-	// a chord shaped tetromino
-	class Chord : public Tetromino
-	{
-		public:
-		    // constructor
-		    Chord(bcgColor c) {
-		        setBrickColor(c); shapeType = Type::Chord; shapeState = State::Up; cbits[0] = initialColumn = 20;
-		    }
-		    
-		    // returns the shape based on its state
-		    Block getShape() {
-		    	// the leftmost col will always be the column of the first block irrespective of rotation
-		    	 ;
-		    	switch (shapeState) {
-                	case State::Up:    setbits(0,0,0,2,0,4,0,6); return (Block(color(white,brickColor)+cursor(rbits[0],cbits[0])+brick+brick+brick+brick)); break;
-                	case State::Right: setbits(0,0,1,0,2,0,3,0); return (Block(color(white,brickColor)+cursor(rbits[0],cbits[0])+brick+cursor(rbits[1],cbits[1])+brick+cursor(rbits[2],cbits[2])+brick+cursor(rbits[3],cbits[3])+brick)); break;		    	   
-		    	    case State::Down:  setbits(0,0,0,2,0,4,0,6); return (Block(color(white,brickColor)+cursor(rbits[0],cbits[0])+brick+brick+brick+brick)); break;
-		            case State::Left:  setbits(0,0,1,0,2,0,3,0); return (Block(color(white,brickColor)+cursor(rbits[0],cbits[0])+brick+cursor(rbits[1],cbits[1])+brick+cursor(rbits[2],cbits[2])+brick+cursor(rbits[3],cbits[3])+brick)); break;
-		    	}
-		    }
-		    // specifically rotate this shape
-		    Block rotate() {
-		    	// clean the previous shape
-		    	erase();
-		    	
-		    	// rotate the shape 90 degrees clockwise relative to its previous state
-		    	switch (shapeState) {
-		    		case State::Up: shapeState = State::Right;   setbits(-1,2,1,0,2,0,3,0); return getShape(); break;		    	   
-		    	    case State::Right: shapeState = State::Down; setbits(1,-4,0,2,0,4,0,6); return getShape(); break;
-		            case State::Down: shapeState = State::Left;  setbits(-2,4,1,0,2,0,3,0); return getShape(); break;
-		    	}
-		    	// return initial shape
-		        shapeState = State::Up; setbits(2,-2,0,2,0,4,0,6); return (getShape());
-		    }
-	};
-	
-	// a square shaped tetromino
-	class Square : public Tetromino
-	{
-		public:
-		    // constructor 
-		    Square(bcgColor c) {
-		        setBrickColor(c); shapeType = Type::Square;
-		    }
-		    
-		    // a square has one state : undefined
-		    Block getShape() { setbits(0,0,0,2,1,0,1,2); return (Block(color(white,brickColor)+cursor(rbits[0],cbits[0])+brick+brick+cursor(rbits[2],cbits[2])+brick+brick)); }
-		    
-		    Block rotate() {
-		    	// clean the previous shape
-		    	erase();
-		    	
-		    	// a square is the same despite rotation
-		    	return (getShape());
-		    }
-	};
-	
-	// a T shaped tetromino
-	class TBlock : public Tetromino
-	{
-		public:
-		    // constructor 
-		    TBlock(bcgColor c) {
-		        setBrickColor(c); shapeType = Type::TBlock; shapeState = State::Up;
-		    }
-		    
-		    Block getShape() {
-		    	switch (shapeState) {
-                    case State::Up:    setbits(0,0,0,2,0,4,1,2);  return (Block(color(white,brickColor)+cursor(rbits[0],cbits[0])+brick+brick+brick+cursor(rbits[3],cbits[3])+brick)); break;
-		    	    case State::Right: setbits(0,0,1,-2,1,0,2,0); return (Block(color(white,brickColor)+cursor(rbits[0],cbits[0])+brick+cursor(rbits[1],cbits[1])+brick+brick+cursor(rbits[3],cbits[3])+brick)); break;
-		    	    case State::Down:  setbits(0,0,1,-2,1,0,1,2); return (Block(color(white,brickColor)+cursor(rbits[0],cbits[0])+brick+cursor(rbits[1],cbits[1])+brick+brick+brick)); break;
-		    	    case State::Left:  setbits(0,0,1,0,1,2,2,0);  return (Block(color(white,brickColor)+cursor(rbits[0],cbits[0])+brick+cursor(rbits[1],cbits[1])+brick+brick+cursor(rbits[3],cbits[3])+brick)); break;
-		    	}
-		    }
-		    // specifically rotate this shape
-		    Block rotate() {
-		    	// clean the previous shape
-		    	erase();
-		    	
-		    	// rotate the shape 90 degrees clockwise relative to its previous state
-		    	switch (shapeState) {
-		    	    case State::Up: shapeState = State::Right;   setbits(-1,2,1,-2,1,0,2,0); return getShape(); break;
-		    	    case State::Right: shapeState = State::Down; setbits(0,0,1,-2,1,0,1,2);  return getShape(); break;
-		    	    case State::Down: shapeState = State::Left;  setbits(0,0,1,0,1,2,2,0);   return getShape(); break;
-		    	}
-		    	// return initial shape
-		    	shapeState = State::Up; setbits(1,-2,0,2,0,4,1,2); return (getShape());
-		    }
-	};
-	
-	// an L shaped tetromino
-	class LBlock : public Tetromino
-	{
-		public:
-		    // constructor 
-		    LBlock(bcgColor c) {
-		        setBrickColor(c); shapeType = Type::LBlock; shapeState = State::Up;
-		    }
-		    
-		    Block getShape() {
-		    	switch (shapeState) {
-		    		case State::Up:    setbits(0,0,0,2,0,4,1,0);   return (Block(color(white,brickColor)+cursor(rbits[0],cbits[0])+brick+brick+brick+cursor(rbits[3],cbits[3])+brick)); break;
-		    		case State::Right: setbits(0,0,0,2,1,2,2,2);   return (Block(color(white,brickColor)+cursor(rbits[0],cbits[0])+brick+brick+cursor(rbits[2],cbits[2])+brick+cursor(rbits[3],cbits[3])+brick)); break;
-		    	    case State::Down:  setbits(0,0,1,-4,1,-2,1,0); return (Block(color(white,brickColor)+cursor(rbits[0],cbits[0])+brick+cursor(rbits[1],cbits[1])+brick+brick+brick)); break;
-		    	    case State::Left:  setbits(0,0,1,0,2,0,2,2);   return (Block(color(white,brickColor)+cursor(rbits[0],cbits[0])+brick+cursor(rbits[1],cbits[1])+brick+cursor(rbits[2],cbits[2])+brick+brick)); break;
-		    	}
-		    }
-		    // specifically rotate this shape
-		    Block rotate() {
-		    	// clean the previous shape
-		    	erase();
-		    	
-		    	// rotate the shape 90 degrees clockwise relative to its previous state
-		    	switch (shapeState) {
-		    		case State::Up: shapeState = State::Right;   setbits(-1,0,0,2,1,2,2,2);  return getShape(); break;
-		    	    case State::Right: shapeState = State::Down; setbits(0,4,1,-4,1,-2,1,0); return getShape(); break;
-		    	    case State::Down: shapeState = State::Left;  setbits(0,-2,1,0,2,0,2,2);  return getShape(); break;
-		    	}
-		    	// return initial shape
-		        shapeState = State::Up; setbits(1,-2,0,2,0,4,1,0); return (getShape());
-		    }
-	};
-	
-	// a reversed L shaped tetromino
-	class RLBlock : public Tetromino
-	{
-		public:
-		    // constructor 
-		    RLBlock(bcgColor c) {
-		        setBrickColor(c); shapeType = Type::RLBlock; shapeState = State::Up;
-		    }
-		    
-		    Block getShape() {
-		    	switch (shapeState) {
-		    		case State::Up:    setbits(0,0,0,2,0,4,1,4);  return (Block(color(white,brickColor)+cursor(rbits[0],cbits[0])+brick+brick+brick+cursor(rbits[3],cbits[3])+brick)); break;
-		    		case State::Right: setbits(0,0,1,0,2,-2,2,0); return (Block(color(white,brickColor)+cursor(rbits[0],cbits[0])+brick+cursor(rbits[1],cbits[1])+brick+cursor(rbits[2],cbits[2])+brick+brick)); break;
-		    	    case State::Down:  setbits(0,0,1,0,1,2,1,4);  return (Block(color(white,brickColor)+cursor(rbits[0],cbits[0])+brick+cursor(rbits[1],cbits[1])+brick+brick+brick)); break;
-		    	    case State::Left:  setbits(0,0,0,2,1,0,2,0);  return (Block(color(white,brickColor)+cursor(rbits[0],cbits[0])+brick+brick+cursor(rbits[2],cbits[2])+brick+cursor(rbits[3],cbits[3])+brick)); break;
-		    	}
-		    }
-		    // specifically rotate this shape
-		    Block rotate() {
-		    	// clean the previous shape
-		    	erase();
-		    	
-		    	// rotate the shape 90 degrees clockwise relative to its previous state
-		    	switch (shapeState) {
-		    		case State::Up: shapeState = State::Right;   setbits(-1,2,1,0,2,-2,2,0); return getShape(); break;
-		    	    case State::Right: shapeState = State::Down; setbits(0,-2,1,0,1,2,1,4);  return getShape(); break;
-		    	    case State::Down: shapeState = State::Left;  setbits(0,2,0,2,1,0,2,0);   return getShape(); break;
-		    	}
-		    	// return initial shape
-		    	shapeState = State::Up; setbits(1,-2,0,2,0,4,1,4); return (getShape());
-		    }
-	};
-	
-	// a Z shaped tetromino
-	class ZBlock : public Tetromino
-	{
-		public:
-		    // constructor 
-		    ZBlock(bcgColor c) {
-		        setBrickColor(c); shapeType = Type::ZBlock; shapeState = State::Up;
-		    }
-		    
-		    Block getShape() {
-		    	switch (shapeState) {
-		    		case State::Up:    setbits(0,0,0,2,1,2,1,4);   return (Block(color(white,brickColor)+cursor(rbits[0],cbits[0])+brick+brick+cursor(rbits[2],cbits[2])+brick+brick)); break;
-		    		case State::Right: setbits(0,0,1,-2,1,0,2,-2); return (Block(color(white,brickColor)+cursor(rbits[0],cbits[0])+brick+cursor(rbits[1],cbits[1])+brick+brick+cursor(rbits[3],cbits[3])+brick)); break;
-		    	    case State::Down:  setbits(0,0,0,2,1,2,1,4);   return (Block(color(white,brickColor)+cursor(rbits[0],cbits[0])+brick+brick+cursor(rbits[2],cbits[2])+brick+brick)); break;
-		    	    case State::Left:  setbits(0,0,1,-2,1,0,2,-2); return (Block(color(white,brickColor)+cursor(rbits[0],cbits[0])+brick+cursor(rbits[1],cbits[1])+brick+brick+cursor(rbits[3],cbits[3])+brick)); break;
-		    	}
-		    }
-		    // specifically rotate this shape
-		    Block rotate() {
-		    	// erase the previous shape
-		    	erase();
-		    	
-		    	// rotate the shape 90 degrees clockwise relative to its previous state
-		    	switch (shapeState) {
-		    		case State::Up: shapeState = State::Right;   setbits(-1,2,1,-2,1,0,2,-2); return getShape(); break;
-		    	    case State::Right: shapeState = State::Down; setbits(0,-2,0,2,1,2,1,4);   return getShape(); break;
-		    	    case State::Down: shapeState = State::Left;  setbits(0,4,1,-2,1,0,2,-2);  return getShape(); break;
-		    	}
-		    	// return initial shape
-		    	shapeState = State::Up; setbits(1,-4,0,2,1,2,1,4); return (getShape());
-		    }
-	};
-	
-	// a reversed Z shaped tetromino
-	class RZBlock : public Tetromino
-	{
-		public:
-		    // constructor 
-		    RZBlock(bcgColor c) {
-		        setBrickColor(c); shapeType = Type::RZBlock; shapeState = State::Up; cbits[0] = initialColumn = 24;
-		    }
-		    
-		    Block getShape() {
-		    	switch (shapeState) {
-		    		case State::Up:    setbits(0,0,0,2,1,-2,1,0); return (Block(color(white,brickColor)+cursor(rbits[0],cbits[0])+brick+brick+cursor(rbits[2],cbits[2])+brick+brick)); break;
-		    		case State::Right: setbits(0,0,1,0,1,2,2,2);  return (Block(color(white,brickColor)+cursor(rbits[0],cbits[0])+brick+cursor(rbits[1],cbits[1])+brick+brick+cursor(rbits[3],cbits[3])+brick)); break;
-		    		case State::Down:  setbits(0,0,0,2,1,-2,1,0); return (Block(color(white,brickColor)+cursor(rbits[0],cbits[0])+brick+brick+cursor(rbits[2],cbits[2])+brick+brick)); break;
-		    		case State::Left:  setbits(0,0,1,0,1,2,2,2);  return (Block(color(white,brickColor)+cursor(rbits[0],cbits[0])+brick+cursor(rbits[1],cbits[1])+brick+brick+cursor(rbits[3],cbits[3])+brick)); break;
-		    	}
-		    }
-		    // specifically rotate this shape
-		    Block rotate() {
-		    	// erase the previous shape
-		    	erase();
-		    	
-		    	// rotate the shape 90 degrees clockwise relative to its previous state
-		    	switch (shapeState) {
-		    		case State::Up: shapeState = State::Right;   setbits(-1,-2,1,0,1,2,2,2); return getShape(); break;
-		    		case State::Right: shapeState = State::Down; setbits(0,2,0,2,1,-2,1,0);  return getShape(); break;
-		    		case State::Down: shapeState = State::Left;  setbits(0,0,1,0,1,2,2,2);   return getShape(); break;
-		    	}
-		    	// return initial shape
-		    	shapeState = State::Up; setbits(1,0,0,2,1,-2,1,0); return (getShape());
-		    }
-	};
-	
-	class ShapeContainer
-    {
-    	private:
-    	    // create the tetrominoes
-	        Chord chord = Chord(Red); Square square = Square(Pink); TBlock tblock = TBlock(Green); LBlock lblock = LBlock(Yellow);  ZBlock zblock = ZBlock(Blue); RLBlock rlblock = RLBlock(Cyan); RZBlock rzblock = RZBlock(DarkGray);
-	    public:
-	        // randomly selects a shape
-	        auto selectShape() {
-	        	static std::vector<Tetromino*> tetrominoArray {&chord,&square,&tblock,&lblock,&rlblock,&zblock,&rzblock};
-	        	// random number generation process
-	        	static std::random_device randomDevice;
-	        	static std::uniform_int_distribution dist(0,6);
-	        	
-	        	// select a type
-	        	return tetrominoArray[dist(randomDevice)];
-	        }
-    };
-    
-    // create an object that contains the tetrominoes
-    ShapeContainer shapes;
-    
-    // sets the tetromino to its initial details
-    void reset(Tetromino* tetromino) {
-		tetromino->modifyRBit(0,9);
-		tetromino->modifyCBit(0,tetromino->getInitialColumn());
-		for (int i = 1; i <= 3; ++i) {
-		    tetromino->modifyRBit(i,0); tetromino->modifyCBit(i,0);
-	    }
-	    tetromino->setShapeState(State::Up);
+	// wakes the game up when a key is pressed or the tetromino has to fall
+	EventLoop events;
+
+	// every game is recorded so it can be played again with --replay
+	Replay recording;
+	std::chrono::steady_clock::time_point gameStarted;
+
+	// applies an input to the game and records it
+	void play(GameEngine& engine,const Input& input) {
+		unsigned milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now()-gameStarted).count();
+		recording.record(milliseconds,input);
+		apply(engine,input);
+	}
+
+	// plays the game instead of the user when the game is started with --autoplay
+	bool autoplay = false;
+	// how the shapes of a game are picked, 7 at a time unless the game is started with --uniform
+	Randomizer randomizer = Randomizer::Bag;
+	Bot bot;
+
+#ifdef TETRIS_BROADCAST
+	// sends the games started from the menu to spectators when the game is started with --broadcast
+	Broadcast broadcast;
+#endif
+
+    // shows how many microseconds it took from a key being pressed to it being handled and drawn
+    void updateLatency() {
+    	drawLatency(events.getLastLatency());
     }
-    
-    // set all game resources to default values
-    void clearResources() {
-    	// clear the array that stores the position of each tetromino block
-    	bitsArray.clear();
-        // clear the array that stores each tetromino shape and their position on screen
-    	blocksArray.clear();
-    	// the matrix has been cleared so it has nothing in it
-    	full = lineIsFormed = dropped = false;
+
+    // sends whatever changed on the matrix, the next shape box and the scores to the screen in one write
+    void refresh() {
+    	TRACE_SCOPE("refresh");
+    	const std::string& cells = renderer.present();
+    	if (!cells.empty()) frame << cells << cursor() << color();
+    	frame.flush();
     }
-    
-    // gets user command and performs an action based on it
-    int getActionCommand(Tetromino* tetromino,bool access = false) {
-    	if (kbhit()||access) {
-    		
-    		// get user input
-        	actionCommand = getch();
-        	
-        	// perform an action
-            switch (actionCommand) {
-            	case '#': reset(tetromino); clearResources(); return 1; // break;
-    	    	case '4': tetromino->moveLeft(); break;
-        		case '6': tetromino->moveRight(); break;
-    	    	case '5': tetromino->turn(); break;
-    	    	case '0': dropType = Drop::Instant; break;
-    	    	/* case '8':
-    	    	    // store the current position
-    	    	    tetromino->storeCurrentPos();
-    	    	    // erase the previous shape
-    	    	    tetromino->erase();
-    	    	    // drop the shape one row below irrespective of delay period
-    	    	    tetromino->modifyRBit(0,tetromino->getrbits(0)+1);
-    	    	    // display the shape
-    	    	    screen.display(tetromino->getShape());
-    	    	    tetromino->setBitSet(false); dropType = Drop::Normal;
-    	    	break; */
-    	        // pause the game
-    	        default: return getActionCommand(tetromino,true); break;
-    	    }
-    	}
+
+    // performs an action based on the key the user pressed. Returns 1 if the user wants to leave the game
+    int getActionCommand(GameEngine& engine,const char& key) {
+        switch (key) {
+        	case '#': return 1; // break;
+	    	case '4': play(engine,Input::Left); break;
+    		case '6': play(engine,Input::Right); break;
+	    	case '5': play(engine,Input::Rotate); break;
+	    	case '0': play(engine,Input::Drop); break;
+	        // pause the game until another key is pressed, then give the tetromino its full delay again
+	        default: {
+	            int result = getActionCommand(engine,events.waitForKey());
+	            events.start(delay); return result;
+	        } break;
+	    }
     	return 0;
     }
-    
-    // updates the scores during gameplay
-    void updateScores() {
-    	screen.display(color(pink)+center("Score: "+color(green)+std::to_string(tetrisData->getScore()),15,42,62,green));
-		screen.display(color(pink)+center("Lines: "+color(green)+std::to_string(tetrisData->getLinesCleared()),18,42,62,green));
-    }
-    
-    // determines if a shape cannot enter the matrix
-    bool matrixIsFull(Tetromino *tetromino) {
-    	// store the current coordinates of the tetromino
-    	tetromino->storeCurrentPos();
-    	// check if the shape can be pushed into the matrix without colliding
-    	tetromino->getShape(); // doesn't display. It just invisibly does the same thing as it would when displayed
-    	tetromino->setBitSet(false);
-    	
-    	// return the result(true if it can fit in the matrix,otherwise false)
-    	return full;
-    }
-    
-    inline void clearMatrix() {
-    	for (int i = 9; i < 29; ++i) std::cout << cursor(i,14) << color() << std::string(20,' ');
-    }
-    
-    void GameOver() {
+
+    // shows that the game is over and stores the scores, unless they were made by the bot
+    void GameOver(const GameEngine& engine,const bool& store = true) {
+        TRACE_SCOPE("GameOver");
         Sleep(500); screen.clear();
-    	screen.display("G A M E  O V E R!",17,27,green); std::cout << std::flush;
-    	unsigned score = tetrisData->getScore(),lines = tetrisData->getLinesCleared();
-    	clearResources();
+    	screen.display("G A M E  O V E R!",17,27,green); frame.flush();
+    	unsigned score = engine.getScore(),lines = engine.getLines();
     	// store the scores if they are greater than the one in storage
-    	tetrisData->createGameData();
-    	if (score > tetrisData->getHighestScore()) tetrisData->setHighestScore(score);
-    	if (lines > tetrisData->getHighestLines()) tetrisData->setHighestLines(lines);
-    	tetrisData->incrementTotalLinesCleared();
-    	tetrisData->incrementGamesPlayed();
-    	tetrisData->createGameData();
-    	// reset the current game scores
-    	tetrisData->setDefaultGameScores();
-    	    
-    	Sleep(5000);
-    	actionCommand = '#';
-    }
-    
-    // checks if a line has been formed
-    void checkLine(Tetromino* tetromino) {
-    	for (int i = 0; i < 4; ++i) {
-    		
-    		// assume a line has been formed
-    		lineIsFormed = true;
-    		// the row where the line was formed
-    		int lineRow = tetromino->getrbits(i);
-    		
-    		// check if a line has really been formed
-    		for (int column = 14; column <= 32; column += 2) {
-    			if (std::find(bitsArray.begin(),bitsArray.end(),bit(lineRow,column)) == bitsArray.end()) {
-    				lineIsFormed = false; break;
-    			}
-    		}
+    	if (store) {
+    		if (score > tetrisData->getHighestScore()) tetrisData->setHighestScore(score);
+    		if (lines > tetrisData->getHighestLines()) tetrisData->setHighestLines(lines);
+    		tetrisData->incrementTotalLinesCleared(lines);
+    		tetrisData->incrementGamesPlayed();
+    		tetrisData->createGameData();
     		
-    		// clear the line if it has been formed
-    		if (lineIsFormed) {
-    			// erase the line
-    			std::cout << cursor(lineRow,14) << color() << std::string(20,' ') << std::flush;
-    			for (int column = 14; column <= 32; column += 2) {
-    				// erase that row and its column from the array
-    			    bitsArray.erase(find(bitsArray.begin(),bitsArray.end(),bit(lineRow,column)));
-    			}
-    		    
-    			// now that the line is out of the array, move every block bit above the line down by 1 row
-    		    for (auto& bitObject : bitsArray) {
-    		    	// row 8 and row 29 are border rows so they should not be checked
-    				if (bitObject.row < lineRow && bitObject.column != 12 && bitObject.column != 34 && bitObject.row != 8 && bitObject.row != 29) ++(bitObject.row);
-    			}
-    		    
-    		    // clear the matrix of old block positions
-    		    clearMatrix();
-    		    
-    		    // remove a few blocks from the line cleared in blocksArray
-    			for (auto& e : blocksArray) {
-    				long long index = e.find("\033["+std::to_string(lineRow)+";");
-    				// if a block from the line cleared is in a Block object the array...
-    				if (index != Block::npos) {
-    					long long index1 = e.find("\033["+std::to_string(lineRow+1)+";"),index2 = e.find("\033["+std::to_string(lineRow-1)+";");
-    					// ...remove the block from the Block object in the array
-    					if (index1 == Block::npos && index2 == Block::npos) {
-    							e = "";
-    					} else if ((index1 != Block::npos && index2 != Block::npos)||index2 == Block::npos) {
-    						e = e.erase(index,index1-index);
-    					} else if (index1 == Block::npos) {
-    						e.erase(index);
-    					}
-    				}
-    			    
-    				Block tempBlock = "";
-    				// shift the blocks one row downwards
-    		        while ((index = e.rfind("\033[")) != Block::npos) {
-    		        	std::string row;
-    		        	if (index != 0) {
-    		        		if (e[index+3] != ';' && std::stoi(row = e.substr(index+2,2)) < lineRow) {
-    		        			// increment the row of the block by 1
-    		        		    e.replace(index+2,2,std::to_string(std::stoi(row)+1));
-    		        		} else if (e[index+3] == ';' && std::stoi(row = e.substr(index+2,1)) < lineRow) {
-    		        			// increment the row of the block by 1
-    		        			e.replace(index+2,1,std::to_string(std::stoi(row)+1));
-    		        		}
-    		        		// insert the modified part of the bloxk at the begining of tempBlock
-    		        		tempBlock.insert(0,e.substr(index));
-    		        		// remove the modified part of the block from the object
-    		        		e = e.substr(0,index);
-    		        	} else {
-    		        	    tempBlock.insert(0,e); e = tempBlock; break;
-    		            }
-    		        }
-    		        std::cout << e;
-    			}
-    			
-    			tetrisData->incrementLinesCleared();
-    			tetrisData->incrementScore();
-    			
-    			// update the score
-    			updateScores();
-    		}
-    	}
-    }
-    
-    // sets the position of each block that makes up the tetromino
-    void Tetromino::setbits(int r0,int c0,int r1,int c1,int r2,int c2,int r3,int c3) {
-    	if (!bitSet) {
-        	rbits[0] += r0; // where r1 is the increment or modification
-            cbits[0] += c0; // where c1 is the increment or modification
-            rbits[1] = rbits[0]+r1; cbits[1] = cbits[0]+c1;
-            rbits[2] = rbits[0]+r2; cbits[2] = cbits[0]+c2;
-            rbits[3] = rbits[0]+r3; cbits[3] = cbits[0]+c3;
-            // check if a collision occurs from changing the position of the tetromino
-            collision();
-            bitSet = true;
-    	}
-    }
-    
-    // detects a collision and handles it
-    bool Tetromino::collision(bool return_val) {
-        // assume the shape has not collide with anything
-        bool hasCollision = false;
-        bool BitCollision[4] = {false,false,false,false};
-        // check if the shape collides with anything
-        for (int i = 0; i <= 3; ++i) {
-            if (std::find(bitsArray.begin(),bitsArray.end(),bit(getrbits(i),getcbits(i))) != bitsArray.end()) {
-   		     hasCollision = true; BitCollision[i] = true;
-   	     }
-        }
-   	 if (hasCollision) {
-   	 	if (return_val != false) return hasCollision;
-   	     // how did the collision occur?
-   	     switch (movementType) {
-   	         // from dropping down? then the shape has landed
-   		     case Movement::Down:  if (getrbits(0) == 9/*initialPosition()*/) { full = true; } stayAtCurrentPos(); dropped = true; break;
-   			 // from moving to the left?
-   			 case Movement::Left:  stayAtCurrentPos(); break;
-   			 // from moving to the right?
-   			 case Movement::Right: stayAtCurrentPos(); break;
-   			 // from rotation?
-   			 case Movement::Undefined:
-   			     // rotation collision for a chord
-   			     if (shapeType == Type::Chord) {
-   			         if (shapeState == State::Up) {
-   			     	    if (BitCollision[0]) {
-   			     	        modifyCBit(2);
-   			     	    } else if (BitCollision[2]) {
-   			     	    	modifyCBit(-4);
-   			     	    } else if (BitCollision[3]) {
-   			     	    	modifyCBit(-2);
-   			     	    }
-   			         } else if (shapeState == State::Right) {
-   			             if (BitCollision[0]) {
-   			     	        modifyRBit(1);
-   			     	    } else if (BitCollision[2]) {
-   			     	    	modifyRBit(-2);
-   			     	    } else if (BitCollision[3]) {
-   			     	    	modifyRBit(-1);
-   			     	    }
-   			         } else if (shapeState == State::Down) {
-   			             if (BitCollision[3]) {
-   			     	        modifyCBit(-2);
-   			     	    } else if (BitCollision[1]) {
-   			     	    	modifyCBit(4);
-   			     	    } else if (BitCollision[0]) {
-   			     	    	modifyCBit(2);
-   			     	    }
-   			         } else if (shapeState == State::Left) {
-   			         	if (BitCollision[3]) {
-   			     	        modifyRBit(-1);
-   			     	    } else if (BitCollision[1]) {
-   			     	    	modifyRBit(2);
-   			     	    } else if (BitCollision[0]) {
-   			     	    	modifyRBit(1);
-   			     	    }
-   			         }
-   			         // if collision still occurs after modification then don't rotate the shape
-   			     	if (collision(true)) { stayAtCurrentPos(); }
-   			     // rotation collision for a tblock
-   			     } else if (shapeType == Type::TBlock) {
-   			     	if (shapeState == State::Up) {
-   			     		modifyCBit(2);
-   			     	} else if (shapeState == State::Right) {
-   			     		modifyRBit(1);
-   			     	} else if (shapeState == State::Down) {
-   			     		modifyCBit(-2);
-   			     	} else if (shapeState == State::Left) {
-   			     		modifyRBit(-1);
-   			     	}
-   			     	// if collision still occurs after modification then don't rotate the shape
-   			     	if (collision(true)) { stayAtCurrentPos(); }
-   			     } else if (shapeType == Type::LBlock) {
-   			     	if (shapeState == State::Up) {
-   			     		if (BitCollision[2]) {
-   			     			modifyCBit(-2);
-   			     		} else if (BitCollision[0] || BitCollision[3]) {
-   			     			modifyCBit(2);
-   			     		}
-   			     	} else if (shapeState == State::Right) {
-   			     		if (BitCollision[3]) {
-   			     			modifyRBit(-1);
-   			     		} else if (BitCollision[0] || BitCollision[1]) {
-   			     		    modifyRBit(1);
-   			     		}
-   			     	} else if (shapeState == State::Down) {
-   			     		if (BitCollision[1]) {
-   			     			modifyCBit(2);
-   			     		} else if (BitCollision[0] || BitCollision[3]) {
-   			     		    modifyCBit(-2);
-   			     		}
-   			     	} else if (shapeState == State::Left) {
-   			     		if (BitCollision[0]) {
-   			     			modifyRBit(1);
-   			     		} else if (BitCollision[2] || BitCollision[3]) {
-   			     		    modifyRBit(-1);
-   			     		}
-   			     	}
-   			     	// if collision still occurs after modification then don't rotate the shape
-   			     	if (collision(true)) { stayAtCurrentPos(); }
-   			     } else if (shapeType == Type::RLBlock) {
-   			     	if (shapeState == State::Up) {
-   			     		if (BitCollision[0]) {
-   			     			modifyCBit(2);
-   			     		} else if (BitCollision[2] || BitCollision[3]) {
-   			     			modifyCBit(-2);
-   			     		}
-   			     	} else if (shapeState == State::Right) {
-   			     		if (BitCollision[0]) {
-   			     			modifyRBit(1);
-   			     		} else if (BitCollision[2] || BitCollision[3]) {
-   			     		    modifyRBit(-1);
-   			     		}
-   			     	} else if (shapeState == State::Down) {
-   			     		if (BitCollision[3]) {
-   			     			modifyCBit(-2);
-   			     		} else if (BitCollision[0] || BitCollision[1]) {
-   			     		    modifyCBit(2);
-   			     		}
-   			     	} else if (shapeState == State::Left) {
-   			     		if (BitCollision[3]) {
-   			     			modifyRBit(-1);
-   			     		} else if (BitCollision[0] || BitCollision[1]) {
-   			     		    modifyRBit(1);
-   			     		}
-   			     	}
-   			     	// if collision still occurs after modification then don't rotate the shape
-   			     	if (collision(true)) { stayAtCurrentPos(); }
-   			     } else if (shapeType == Type::ZBlock) {
-   			     	if (shapeState == State::Up) {
-   			     		if (BitCollision[0]) {
-   			     			modifyCBit(2);
-   			     		} else if (BitCollision[3]) {
-   			     			modifyCBit(-2);
-   			     		}
-   			     	} else if (shapeState == State::Right) {
-   			     		if (BitCollision[0]) {
-   			     			modifyRBit(1);
-   			     		} else if (BitCollision[3]) {
-   			     		    modifyRBit(-1);
-   			     		}
-   			     	} else if (shapeState == State::Down) {
-   			     		if (BitCollision[3]) {
-   			     			modifyCBit(-2);
-   			     		} else if (BitCollision[0]) {
-   			     		    modifyCBit(2);
-   			     		}
-   			     	} else if (shapeState == State::Left) {
-   			     		if (BitCollision[3]) {
-   			     			modifyRBit(-1);
-   			     		} else if (BitCollision[0]) {
-   			     		    modifyRBit(1);
-   			     		}
-   			     	}
-   			     	// if collision still occurs after modification then don't rotate the shape
-   			     	if (collision(true)) { stayAtCurrentPos(); }
-   			     } else if (shapeType == Type::RZBlock) {
-   			     	if (shapeState == State::Up) {
-   			     		if (BitCollision[3]) {
-   			     			modifyCBit(4);
-   			     		} else if (BitCollision[2]) {
-   			     			modifyCBit(2);
-   			     		}
-   			     	} else if (shapeState == State::Right) {
-   			     		if (BitCollision[1]) {
-   			     			modifyRBit(2);
-   			     		} else if (BitCollision[0]) {
-   			     		    modifyRBit(1);
-   			     		}
-   			     	} else if (shapeState == State::Down) {
-   			     		if (BitCollision[0]) {
-   			     			modifyCBit(-4);
-   			     		} else if (BitCollision[1]) {
-   			     		    modifyCBit(-2);
-   			     		}
-   			     	} else if (shapeState == State::Left) {
-   			     		if (BitCollision[2]) {
-   			     			modifyRBit(-2);
-   			     		} else if (BitCollision[3]) {
-   			     		    modifyRBit(-1);
-   			     		}
-   			     	}
-   			     	// if collision still occurs after modification then don't rotate the shape
-   			     	if (collision(true)) { stayAtCurrentPos(); }
-   			     }
-   			 break;
-   	     }
-        }
-        // to avoid segfault
-        return false;
-    }
-    
-    // stores the current coordinates (here,anything without "this" does not belong to the class)
-    void Tetromino::storeCurrentPos() {
-    	for (int i = 0; i < 4; ++i) { rowBitStorage[i] = this->getrbits(i); colBitStorage[i] = this->getcbits(i); }
-	    shapeStateInfo = this->shapeState;
-    }
-    
-    // restores the last saved position of the tetromino (here,anything without "this" does not belong to the class)
-    void Tetromino::stayAtCurrentPos() {
-        for (int i = 0; i < 4; ++i) { this->modifyRBit(i,rowBitStorage[i]); this->modifyCBit(i,colBitStorage[i]); }
-	    this->shapeState = shapeStateInfo;
-    }
-    
-    void Tetromino::turn() {
-    	movementType = Movement::Undefined;
-        screen.display(rotate()); std::cout << std::flush;
-        this->storeCurrentPos(); this->bitSet = false;
-    }
-    
-    // fall a tetromino of any type
-    int Tetromino::drop() {
-    	if (!matrixIsFull( this )) {
-        	// wait for user input while waiting to drop the tetromino
-        	for (int x = 2,i = x; dropType == Drop::Normal && i < delay; i += x) { Sleep(x); if (getActionCommand(this) == 1) return 1; }
-        	movementType = Movement::Down;
-        	// clean the previous shape
-        	erase();
-        	// increment the row and print the shape
-            switch (dropType) {
-            	case Drop::Instant: while (!dropped) { storeCurrentPos(); modifyRBit(0,getrbits(0)+1); /* getShape checks collision */ getShape(); bitSet = false; } break;
-            	case Drop::Normal:  modifyRBit(0,getrbits(0)+1); break;
-            }
-        	// display the tetromino on the next row
-        	screen.display(getShape()); std::cout << std::flush;
-        	storeCurrentPos(); bitSet = false; dropType = Drop::Normal;
+    		// and keep the whole game in the history
+    		GameRecord game;
+    		game.score = score; game.lines = lines; game.pieces = engine.getPieces(); game.seed = engine.getSeed();
+    		game.duration = static_cast<std::uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now()-gameStarted).count());
+    		game.time = static_cast<std::uint32_t>(std::time(nullptr));
+    		game.level = static_cast<std::uint8_t>(GameLevelNumber); game.randomizer = static_cast<std::uint8_t>(engine.getRandomizer());
+    		gameHistory.add(game);
     	}
-    	return 0;
-    }
-    
-    // moves a tetromino to the left
-    void Tetromino::moveRight() {
-    	movementType = Movement::Right;
-    	erase();
-    	
-    	modifyCBit(0,getcbits(0)+2);
-    	// display the shape
-    	screen.display(getShape()); std::cout << std::flush;
-    	storeCurrentPos(); bitSet = false;
-    }
-    
-    void Tetromino::moveLeft() {
-    	movementType = Movement::Left;
-    	erase();
-    	
-    	modifyCBit(0,getcbits(0)-2);
-    	// display the shape
-    	screen.display(getShape()); std::cout << std::flush;
-    	storeCurrentPos(); bitSet = false;
-    }
-    
-    // performs an action based on user command
-    int performAction() {
-    	// store the next shape to fall
-        static Tetromino *NextShape;
-        auto tetromino = (NextShape != nullptr)? NextShape : shapes.selectShape();
-        
-        // clear the previous shape in the next shape box
-        for (int i = 7; i <= 8; ++i) { std::cout << cursor(i,48) << color() << std::string(10,' '); }
-        
-         // select and display the next shape to fall
-        NextShape = shapes.selectShape(); NextShape->modifyRBit(-2); NextShape->modifyCBit(28);
-        screen.display(NextShape->getShape()); NextShape->setBitSet(false);
-        reset(NextShape);
-        
-        // end the game if the matrix is full
-        if (matrixIsFull(tetromino)) { GameOver(); NextShape = nullptr; return 0; }
-        
-        // display the current falling shape
-        screen.display(tetromino->getShape()); std::cout << std::flush;
-        tetromino->setBitSet(false);
-        
-        // fall the shape
-    	do {
-    		// the tetromino will always drop but the return statement
-    		// will only run if drop() returns 1
-    		if(tetromino->drop() == 1) return 1; // drop the tetromino
-    	} while (!dropped);
-    	
-    	// code block to maintain reserves for the vectors
-        {
-        	if (bitsArray.size() == bitsArray.capacity()) bitsArray.reserve(bitsArray.capacity()+100);
-        	if (blocksArray.size() == blocksArray.capacity()) blocksArray.reserve(blocksArray.capacity()+100);
-    	}
-    	
-    	// the shape has landed. store its position in the vector
-    	for (int i = 0; i < 4; ++i) {
-    	    bitsArray.push_back(bit(tetromino->getrbits(i),tetromino->getcbits(i)));
-    	}
-    	
-    	// push the shape to the array of Blocks
-    	blocksArray.push_back(tetromino->getShape()); tetromino->setBitSet(false);
-    	
-    	// check if a line has been cleared
-    	checkLine(tetromino);
-    	reset(tetromino); dropped = false;
-    	// return the cursor to the initial position
-    	std::cout << cursor() << color() << std::flush;
-    	return 0;
+
+    	Sleep(5000);
     }
-    
+
     // stops the current game and returns to menu
     void endCurrentGame() {
     	//.....
-    	actionCommand = '\0'; screen.clear(); interface::menu();
+    	screen.clear(); interface::menu();
     }
-    
-	
+
+
 }
 
 // gets user commands in game screen which in turn drives the game
 void startNewGame() {
-	tetris::bitsArray.reserve(1000);
-	tetris::blocksArray.reserve(1000);
-	
-	// set default limits
-	for (int i = 8; i <= 29; ++i) { tetris::bitsArray.push_back(tetris::bit(i,12)); tetris::bitsArray.push_back(tetris::bit(i,34)); }
-	for (int i = 12; i <= 34; i+=2) { tetris::bitsArray.push_back(tetris::bit(8,i)); tetris::bitsArray.push_back(tetris::bit(29,i)); }
-	
-	while (tetris::actionCommand != '#') tetris::performAction();
-	
-	// loop reaches here when the user presses #
-	tetris::endCurrentGame();
+	using namespace tetris;
+
+	unsigned seed = std::random_device()();
+	GameEngine engine(seed,randomizer);
+	TerminalView view;
+	engine.setObserver(&view);
+#ifdef TETRIS_BROADCAST
+	// spectators are told about the game before the view draws it
+	if (broadcast.isOpen()) { broadcast.setNext(&view); engine.setObserver(&broadcast); broadcast.start(engine,GameLevelNumber); }
+#endif
+	recording.start(seed,randomizer,GameLevelNumber,delay);
+	gameStarted = std::chrono::steady_clock::now();
+
+	// the screen was just cleared so nothing the renderer sent before is there anymore
+	renderer.invalidate();
+	view.redraw(engine); updateLatency(); refresh();
+
+	// keys are read as soon as they are pressed while the game runs
+	events.open();
+#ifdef TETRIS_BROADCAST
+	events.watch(broadcast.getFd());
+#endif
+	events.start(delay);
+	unsigned pieces = engine.getPieces();
+
+	// the keys the bot is going to type and how many of them it has typed. It types them a few at a time
+	// within one gravity interval so the moves can be followed
+	std::string plan = autoplay ? bot.keys(bot.choose(engine)) : "";
+	std::size_t typed = 0;
+	const int typingDelay = delay/12;
+
+	while (!engine.isOver()) {
+		Event event = (typed < plan.size()) ? events.wait(typingDelay) : events.wait();
+		bool key = (event == Event::Key);
+		if (key) {
+			// leave the game if the user presses #
+			if (getActionCommand(engine,events.getKey()) == 1) break;
+		} else if (event == Event::Idle) {
+			getActionCommand(engine,plan[typed++]);
+		} else if (event == Event::Peer) {
+#ifdef TETRIS_BROADCAST
+			broadcast.accept();
+#endif
+		} else {
+			play(engine,Input::Gravity);
+		}
+		// every new tetromino gets a full delay before it falls
+		bool spawned = (engine.getPieces() != pieces);
+		if (spawned) { pieces = engine.getPieces(); events.start(delay); }
+
+		// the bot plans again whenever the tetromino is somewhere it didn't move it to
+		if (autoplay && (spawned || event == Event::Gravity)) { plan = bot.keys(bot.choose(engine)); typed = 0; }
+
+		// rows gravity still owes are played before the next frame is drawn, so a slow frame costs frames
+		// rather than slowing the game down
+		if (events.getBacklog() == 0) refresh();
+		if (key) { events.handled(); updateLatency(); }
+#ifdef TETRIS_BROADCAST
+		// spectators get the tick once the player has theirs
+		broadcast.flush();
+#endif
+	}
+	events.close();
+#ifdef TETRIS_BROADCAST
+	broadcast.finish();
+#endif
+
+	// the replay is stored next to the scores, named after when the game ended, with a number after the time
+	// if another game ended in the same second. A game left with # is kept too, up to where it was left, but
+	// games the bot played aren't kept, like their scores
+	if (!autoplay) {
+		std::string name = tetrisData->getFolder()+"tetris-"+std::to_string(static_cast<long long>(std::time(nullptr)));
+		for (int n = 1; !recording.save((n == 1) ? name+".trp" : name+"-"+std::to_string(n)+".trp",false) && errno == EEXIST && n < 1000; ++n) {}
+	}
+
+	if (engine.isOver()) GameOver(engine,!autoplay);
+	endCurrentGame();
+}
+
+// plays a recorded game again, on the screen at the speed it was played or without a screen as fast as possible
+int replayGame(const std::string& path,const bool& headless) {
+	using namespace tetris;
+
+	Replay replay;
+	if (!replay.load(path)) { std::fprintf(stderr,"%s isn't a replay this version can play\n",path.c_str()); return 1; }
+	GameEngine engine(replay.getSeed(),replay.getRandomizer());
+	Replay::Reader reader(replay);
+	unsigned milliseconds = 0,inputs = 0;
+	Input input;
+
+	if (headless) {
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		while (reader.next(milliseconds,input)) { apply(engine,input); ++inputs; }
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+		std::printf("%u inputs over %.1f s of play replayed in %.3f ms (%.0f inputs/s)\n",inputs,milliseconds/1000.0,seconds*1000,inputs/seconds);
+		std::printf("score %u, lines %u, pieces %u%s\n",engine.getScore(),engine.getLines(),engine.getPieces(),engine.isOver() ? ", game over" : "");
+		return 0;
+	}
+
+	// draw the game's page the way the game was played
+	GameLevelNumber = replay.getLevel(); delay = replay.getDelay();
+	frame << "\033[2J";
+	createScreen();
+	interface::gamePage();
+	TerminalView view;
+	engine.setObserver(&view);
+	renderer.invalidate();
+	view.redraw(engine); updateLatency(); refresh();
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	while (!stopRequested && reader.next(milliseconds,input)) {
+		std::this_thread::sleep_until(start+std::chrono::milliseconds(milliseconds));
+		apply(engine,input);
+		refresh();
+	}
+	Sleep(2000);
+	frame << cursor(35,1) << color() << "\033[?25h"; frame.flush();
+	return 0;
+}
+
+// plays 2 to 8 games side by side, each with its own gravity. The user plays the first board and the bot the
+// others, or the bot plays them all with --autoplay. Board i plays the shapes of seed+i, so a game can be
+// played again from its seed. Everything that is already due when the loop wakes up is handled before the
+// frame is drawn, so a frame of all the boards is still one write however many there are
+int splitGame(const int& count,const unsigned& seed) {
+	using namespace tetris;
+	typedef std::chrono::steady_clock Clock;
+
+	setDifficulty();
+	std::vector<std::unique_ptr<SplitBoard>> boards;
+	for (int i = 0; i < count; ++i) {
+		bool played = autoplay || i > 0;
+		boards.emplace_back(new SplitBoard(i,seed+i,randomizer,played,played ? "Bot "+std::to_string(i+1) : "You"));
+	}
+	const int typingDelay = delay/12;
+	int playing = count;
+	bool quit = false;
+
+	// the bot plans where a board's tetromino goes and types the keys for it a few at a time
+	auto plan = [&](SplitBoard& board) {
+		board.plan = bot.keys(bot.choose(board.engine)); board.typed = 0;
+		board.nextKey = Clock::now()+std::chrono::milliseconds(typingDelay);
+	};
+	// once a board has changed: a new tetromino gets a full delay before it falls, the bot plans again whenever
+	// the tetromino is somewhere it didn't move it to, and a board whose game is over stops falling
+	auto changed = [&](const int& i,const bool& fell) {
+		SplitBoard& board = *boards[i];
+		if (board.engine.isOver()) { events.stop(i); --playing; return; }
+		bool spawned = (board.engine.getPieces() != board.pieces);
+		if (spawned) { board.pieces = board.engine.getPieces(); events.start(delay,i); }
+		if (board.bot && (spawned || fell)) plan(board);
+	};
+	auto handle = [&](const Event& event) {
+		if (event == Event::Gravity) {
+			int i = events.getTimer();
+			if (boards[i]->engine.isOver()) return;
+			boards[i]->engine.tick(); changed(i,true);
+		} else if (event == Event::Key) {
+			char key = events.getKey();
+			if (key == '#') { quit = true; return; }
+			SplitBoard& user = *boards[0];
+			if (user.bot || user.engine.isOver()) return;
+			if (user.press(key)) { changed(0,false); return; }
+			// pause every board until another key is pressed, then give every tetromino its full delay again
+			key = events.waitForKey();
+			for (int i = 0; i < count; ++i) if (!boards[i]->engine.isOver()) events.start(delay,i);
+			if (key == '#') quit = true;
+			else if (user.press(key)) changed(0,false);
+		}
+	};
+	// how long until the bot types its next key on any board, -1 if it has nothing to type
+	auto untilNextKey = [&]() {
+		Clock::time_point now = Clock::now(),next = Clock::time_point::max();
+		for (const std::unique_ptr<SplitBoard>& board : boards) {
+			if (board->bot && !board->engine.isOver() && board->typed < board->plan.size() && board->nextKey < next) next = board->nextKey;
+		}
+		if (next == Clock::time_point::max()) return -1;
+		return (next <= now) ? 0 : static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(next-now).count()+1);
+	};
+
+	frame << "\033[2J\033[?25l";
+	renderer.invalidate();
+	events.open();
+	for (int i = 0; i < count; ++i) {
+		boards[i]->view.redraw(boards[i]->engine);
+		events.start(delay,i);
+		if (boards[i]->bot) plan(*boards[i]);
+	}
+	refresh();
+
+	while (playing > 0 && !quit) {
+		handle(events.wait(untilNextKey()));
+		// the rows and keys that are already due are handled before the frame is drawn
+		for (Event event; !quit && (event = events.wait(0)) != Event::Idle; ) handle(event);
+		Clock::time_point now = Clock::now();
+		for (int i = 0; i < count && !quit; ++i) {
+			SplitBoard& board = *boards[i];
+			if (!board.bot || board.engine.isOver() || board.typed == board.plan.size() || now < board.nextKey) continue;
+			board.press(board.plan[board.typed++]);
+			board.nextKey += std::chrono::milliseconds(typingDelay);
+			changed(i,false);
+		}
+		refresh();
+	}
+
+	// the board with the highest score wins
+	unsigned best = 0;
+	for (const std::unique_ptr<SplitBoard>& board : boards) if (board->engine.getScore() > best) best = board->engine.getScore();
+	for (const std::unique_ptr<SplitBoard>& board : boards) if (board->engine.getScore() == best) board->view.showResult("WINNER",green);
+	renderer.text(Renderer::rows,2,"Press any key to leave",darkgray,Normal);
+	refresh();
+	events.waitForKey();
+	events.close();
+	frame << cursor(35,1) << color() << "\033[?25h"; frame.flush();
+	return 0;
+}
+
+#ifdef TETRIS_VERSUS
+// plays against another tetris started with the same socket. Both games send every input to the other side,
+// which plays it again on a shadow engine that its mini view is drawn from. Lines cleared by the opponent,
+// as its shadow engine clears them, send garbage rows up under the matrix. The messages of a tick go out in
+// one write, and every time a tetromino lands the game's hash goes with them, so the other side can tell if
+// its shadow engine no longer plays the same game
+int versusGame(const std::string& path) {
+	using namespace tetris;
+	using versus::Kind;
+	using versus::Message;
+
+	std::printf("waiting for an opponent on %s...\n",path.c_str()); std::fflush(stdout);
+	versus::Link link;
+	if (!link.open(path)) { std::fprintf(stderr,"couldn't play over %s: %s\n",path.c_str(),std::strerror(errno)); return 1; }
+	unsigned seed = std::random_device()();
+	link.send(Message{Kind::Hello,versus::version,static_cast<std::uint8_t>(randomizer),0,seed});
+	Message hello;
+	if (!link.flush() || !link.next(hello,10000) || hello.kind != Kind::Hello || hello.input != versus::version || !versus::valid(hello)) {
+		std::fprintf(stderr,"the other side of %s isn't a game this version can play against\n",path.c_str()); return 1;
+	}
+
+	setDifficulty();
+	GameEngine engine(seed,randomizer),rival(hello.value,static_cast<Randomizer>(hello.count));
+	TerminalView view;
+	RivalView rivalView;
+	engine.setObserver(&view); rival.setObserver(&rivalView);
+	// where the holes of the garbage this side gets go
+	Xoshiro128 holes(seed);
+
+	frame << "\033[2J";
+	createScreen();
+	interface::gamePage();
+	renderer.invalidate();
+	view.redraw(engine); rivalView.redraw(rival); refresh();
+
+	// applies an input to the game and sends it to the other side
+	auto input = [&](const Input& input) {
+		apply(engine,input);
+		link.send(Message{Kind::Input,static_cast<std::uint8_t>(input),0,0,0});
+	};
+	auto press = [&](const char& key) {
+		switch (key) {
+			case '4': input(Input::Left); break;
+			case '6': input(Input::Right); break;
+			case '5': input(Input::Rotate); break;
+			case '0': input(Input::Drop); break;
+		}
+	};
+	// once the opponent's game can't be followed (its hash differs, or a message couldn't have come from a
+	// game) its inputs and garbage are no longer played on the shadow engine
+	bool rivalOver = false,desynced = false;
+	auto desync = [&]() { if (!desynced) { desynced = true; rivalView.showStatus("OUT OF SYNC",red); } };
+	auto handle = [&](const Message& message) {
+		if (!versus::valid(message)) { desync(); return; }
+		switch (message.kind) {
+			case Kind::Input: if (!desynced) apply(rival,static_cast<Input>(message.input)); break;
+			case Kind::Garbage: if (!desynced) rival.addGarbage(message.count,message.hole); break;
+			case Kind::Hash:
+				if (!desynced && versus::hashOf(rival) != message.value) desync();
+				break;
+			case Kind::Over:
+				rivalOver = true;
+				if (!rival.isOver()) rivalView.showStatus("RIVAL LEFT",green);
+				break;
+			default: break;
+		}
+		// the lines the opponent just cleared send garbage here, which the opponent is told about so its
+		// shadow of this game gets it at the same point
+		int rows = rivalView.takeAttack();
+		if (rows > 0) {
+			int hole = static_cast<int>(holes.below(Board::width));
+			engine.addGarbage(rows,hole);
+			link.send(Message{Kind::Garbage,0,static_cast<std::uint8_t>(rows),static_cast<std::uint8_t>(hole),0});
+		}
+	};
+
+	events.open();
+	events.watch(link.getFd());
+	events.start(delay);
+	unsigned pieces = engine.getPieces();
+	std::string plan = autoplay ? bot.keys(bot.choose(engine)) : "";
+	std::size_t typed = 0;
+	const int typingDelay = delay/12;
+	bool quit = false;
+
+	while (!engine.isOver() && !rivalOver && !quit) {
+		Event event = (typed < plan.size()) ? events.wait(typingDelay) : events.wait();
+		switch (event) {
+			case Event::Key:
+				if (events.getKey() == '#') quit = true;
+				else press(events.getKey());
+				break;
+			case Event::Idle: press(plan[typed++]); break;
+			case Event::Gravity: input(Input::Gravity); break;
+			case Event::Peer:
+				if (!link.receive(handle)) { rivalOver = true; rivalView.showStatus("RIVAL LEFT",green); events.watch(-1); }
+				break;
+		}
+		bool spawned = (engine.getPieces() != pieces);
+		if (spawned) {
+			pieces = engine.getPieces(); events.start(delay);
+			link.send(Message{Kind::Hash,0,0,0,versus::hashOf(engine)});
+		}
+		if (autoplay && (spawned || event == Event::Gravity)) { plan = bot.keys(bot.choose(engine)); typed = 0; }
+		if (engine.isOver() || quit) link.send(Message{Kind::Over,0,0,0,0});
+		// everything this tick sent goes out in one write before the frame is drawn. A side that stopped reading
+		// is gone as much as one that left
+		if (!link.flush() && !rivalOver) { rivalOver = true; rivalView.showStatus("RIVAL LEFT",green); events.watch(-1); }
+		if (events.getBacklog() == 0) refresh();
+	}
+	events.close();
+	link.close();
+
+	Sleep(500); screen.clear();
+	if (engine.isOver() || quit) screen.display("Y O U  L O S E",17,28,red);
+	else screen.display("Y O U  W I N !",17,28,green);
+	frame.flush();
+	Sleep(3000);
+	frame << cursor(35,1) << color() << "\033[?25h"; frame.flush();
+	return 0;
+}
+#endif
+
+// writes the trace once the game has ended. A signal only asks the game to stop, so this runs on the way out
+// of main with the terminal already given back, never inside the signal handler
+void writeTrace() {
+	if (!tetris::trace::stop()) std::fprintf(stderr,"the trace couldn't be written to %s\n",tetris::trace::output.c_str());
 }
 
 // code execution starts from here
-int main()
+int main(int argc,char* argv[])
 {
+	// Ctrl-C, kill and the terminal closing end the game the way # does, so the terminal is given back
+	tetris::catchStopSignals();
+	// record where the time goes and write it as a Chrome trace when the game ends
+	for (int i = 1; i+1 < argc; ++i) {
+		if (std::strcmp(argv[i],"--trace") == 0) {
+			if (!tetris::trace::start(argv[i+1])) { std::fprintf(stderr,"this build has no trace spans (TETRIS_TRACE is 0)\n"); return 1; }
+			std::atexit(writeTrace);
+		}
+	}
+	// play a recorded game instead of the menu
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i],"--replay") == 0 && i+1 < argc) {
+			bool headless = false;
+			for (int j = 1; j < argc; ++j) if (std::strcmp(argv[j],"--headless") == 0) headless = true;
+			return replayGame(argv[i+1],headless);
+		}
+	}
+	// let the bot play every game
+	for (int i = 1; i < argc; ++i) if (std::strcmp(argv[i],"--autoplay") == 0) tetris::autoplay = true;
+	// keep the scores and replays somewhere other than the default folder
+	for (int i = 1; i+1 < argc; ++i) {
+		if (std::strcmp(argv[i],"--data") == 0) {
+			std::string folder = argv[i+1];
+			if (!folder.empty() && folder.back() != '/') folder += '/';
+			tetrisData->setFolder(folder);
+		}
+	}
+	// pick every shape on its own, as the game used to, instead of from bags of 7
+	for (int i = 1; i < argc; ++i) if (std::strcmp(argv[i],"--uniform") == 0) tetris::randomizer = tetris::Randomizer::Uniform;
+
+	// play against another game on the same machine instead of the menu
+	for (int i = 1; i+1 < argc; ++i) {
+		if (std::strcmp(argv[i],"--versus") == 0) {
+#ifdef TETRIS_VERSUS
+			return versusGame(argv[i+1]);
+#else
+			std::fprintf(stderr,"--versus needs Unix domain sockets, which this build doesn't have\n"); return 1;
+#endif
+		}
+	}
+	// let spectators watch the games started from the menu
+	for (int i = 1; i+1 < argc; ++i) {
+		if (std::strcmp(argv[i],"--broadcast") == 0) {
+#ifdef TETRIS_BROADCAST
+			if (!tetris::broadcast.open(argv[i+1])) { std::fprintf(stderr,"--broadcast couldn't listen on %s\n",argv[i+1]); return 1; }
+#else
+			std::fprintf(stderr,"--broadcast needs Unix domain sockets, which this build doesn't have\n"); return 1;
+#endif
+		}
+	}
+	// play several boards side by side instead of the menu, from a seed if one is given
+	for (int i = 1; i+1 < argc; ++i) {
+		if (std::strcmp(argv[i],"--split") == 0) {
+			int count = std::atoi(argv[i+1]);
+			if (count < 2 || count > tetris::maxBoards) { std::fprintf(stderr,"--split takes 2 to %d boards\n",tetris::maxBoards); return 1; }
+			unsigned seed = std::random_device()();
+			for (int j = 1; j+1 < argc; ++j) if (std::strcmp(argv[j],"--seed") == 0) seed = static_cast<unsigned>(std::strtoul(argv[j+1],nullptr,10));
+			return splitGame(count,seed);
+		}
+	}
+
 	// start the game application
 	runGame();
-}
\ No newline at end of file
+}
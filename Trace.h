@@ -0,0 +1,182 @@
+#ifndef TRACE_H
+#define TRACE_H
+//=================================================================================================================================//
+// needed header files
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#if (defined(__x86_64__)||defined(__i386__))&&(defined(__GNUC__)||defined(__clang__))
+#define TETRIS_TSC
+#include <x86intrin.h>
+#endif
+// the trace spans are built in unless TETRIS_TRACE is 0. Built in, they only record once tracing is started
+#ifndef TETRIS_TRACE
+#define TETRIS_TRACE 1
+#endif
+//=================================================================================================================================//
+
+// times the span of the block it is put in, named by a string literal
+#if TETRIS_TRACE
+#define TRACE_JOIN2(a,b) a##b
+#define TRACE_JOIN(a,b) TRACE_JOIN2(a,b)
+#define TRACE_SCOPE(name) tetris::trace::Span TRACE_JOIN(traceSpan,__LINE__)(name)
+#else
+#define TRACE_SCOPE(name) ((void)0)
+#endif
+
+// namespace to contain specific assets used during gameplay
+namespace tetris
+{
+	// records how long the game spends in the spans marked with TRACE_SCOPE and writes them out as a trace that
+	// chrome://tracing and Perfetto open. Every thread records into a buffer of its own, so recording a span
+	// takes no lock, and the buffers are only read when the trace is written
+	namespace trace
+	{
+		// a span as it was recorded, in ticks of now()
+		struct Event {
+			const char* name;
+			std::uint64_t begin,end;
+		};
+
+		// the spans one thread recorded, in chunks so recording never moves the ones before
+		class Buffer
+		{
+			private:
+			    static constexpr std::size_t chunkSize = 1 << 16;
+			    static constexpr std::size_t maxChunks = 32;
+
+			    std::vector<std::unique_ptr<Event[]>> chunks;
+			    // where the next span goes and the end of the chunk it is in, so recording a span only compares
+			    // two pointers. The chunks before the current one are full
+			    Event* next = nullptr;
+			    Event* last = nullptr;
+			    std::size_t current = 0,dropped = 0;
+			    unsigned thread;
+
+			    // moves on to the next chunk, made the first time it is needed. Returns false once the buffer is
+			    // full: it stops taking spans rather than use up the memory
+			    bool grow() {
+			    	std::size_t chunk = (next == nullptr) ? 0 : current+1;
+			    	if (chunk == maxChunks) return false;
+			    	if (chunk == chunks.size()) chunks.emplace_back(new Event[chunkSize]);
+			    	current = chunk; next = chunks[chunk].get(); last = next+chunkSize;
+			    	return true;
+			    }
+
+			public:
+			    Buffer(const unsigned& thread): thread(thread) {} /* constructor */
+
+			    // getter methods
+			    inline unsigned getThread() const { return this->thread; }
+			    inline std::size_t getCount() const { return (next == nullptr) ? 0 : current*chunkSize+static_cast<std::size_t>(next-chunks[current].get()); }
+			    inline std::size_t getDropped() const { return this->dropped; }
+			    inline const Event& get(const std::size_t& i) const { return chunks[i/chunkSize][i%chunkSize]; }
+
+			    inline void add(const char* name,const std::uint64_t& begin,const std::uint64_t& end) {
+			    	if (next == last && !grow()) { ++dropped; return; }
+			    	*next++ = Event{name,begin,end};
+			    }
+
+			    // forgets the spans recorded, keeping the memory they were in
+			    inline void clear() { next = last = nullptr; current = dropped = 0; }
+		};
+
+		// is a trace being recorded?
+		std::atomic<bool> enabled{false};
+		// every thread's buffer, which outlive the threads so their spans can be written at the end
+		std::mutex buffersLock;
+		std::vector<std::unique_ptr<Buffer>> buffers;
+		thread_local Buffer* threadBuffer = nullptr;
+
+		// where the trace is written and when it started
+		std::string output;
+		std::uint64_t startTicks = 0;
+		std::chrono::steady_clock::time_point startTime;
+
+		// a timestamp: the processor's time stamp counter where there is one, which is cheaper to read than the
+		// clock, otherwise the steady clock in nanoseconds
+		inline std::uint64_t now() {
+#ifdef TETRIS_TSC
+			return __rdtsc();
+#else
+			return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+		}
+
+		// the calling thread's buffer, made the first time the thread records a span
+		inline Buffer& local() {
+			if (threadBuffer == nullptr) {
+				std::lock_guard<std::mutex> guard(buffersLock);
+				buffers.emplace_back(new Buffer(static_cast<unsigned>(buffers.size()+1)));
+				threadBuffer = buffers.back().get();
+			}
+			return *threadBuffer;
+		}
+
+		// times a span from when it is made to when it goes out of scope. It records nothing unless a trace
+		// is being recorded when it is made
+		class Span
+		{
+			private:
+			    const char* name;
+			    std::uint64_t begin = 0;
+
+			public:
+			    explicit Span(const char* name): name(name) { /* constructor */
+			    	if (enabled.load(std::memory_order_relaxed)) begin = now();
+			    }
+			    ~Span() { if (begin != 0) local().add(name,begin,now()); } /* destructor */
+			    Span(const Span&) = delete;
+			    Span& operator=(const Span&) = delete;
+		};
+
+		// starts recording a trace that stop() writes to a file. Returns false if the spans weren't built in
+		inline bool start(const std::string& path) {
+			output = path;
+			startTime = std::chrono::steady_clock::now(); startTicks = now();
+			enabled = (TETRIS_TRACE != 0);
+			return enabled;
+		}
+
+		// forgets the spans the calling thread has recorded
+		inline void discard() { local().clear(); }
+
+		// stops recording and writes every span recorded as a Chrome trace. It must be called once no other
+		// thread records spans. Returns false if the trace couldn't be written
+		inline bool stop() {
+			if (!enabled.exchange(false)) return false;
+			std::uint64_t ticks = now()-startTicks;
+			double nanoseconds = std::chrono::duration<double,std::nano>(std::chrono::steady_clock::now()-startTime).count();
+			double microsecondsPerTick = (ticks == 0) ? 0 : nanoseconds/ticks/1000;
+
+			std::FILE* file = std::fopen(output.c_str(),"w");
+			if (file == nullptr) return false;
+			std::fprintf(file,"{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+			bool first = true;
+			std::size_t dropped = 0;
+			std::lock_guard<std::mutex> guard(buffersLock);
+			for (const std::unique_ptr<Buffer>& buffer : buffers) {
+				for (std::size_t i = 0; i < buffer->getCount(); ++i) {
+					const Event& event = buffer->get(i);
+					std::fprintf(file,"%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",first ? "" : ",\n",event.name,
+					             buffer->getThread(),(event.begin-startTicks)*microsecondsPerTick,(event.end-event.begin)*microsecondsPerTick);
+					first = false;
+				}
+				dropped += buffer->getDropped();
+				buffer->clear();
+			}
+			std::fprintf(file,"\n]}\n");
+			if (dropped > 0) std::fprintf(stderr,"trace: %zu spans didn't fit in the buffers and were dropped\n",dropped);
+			return std::fclose(file) == 0;
+		}
+
+	} /* end of namespace trace */
+
+} /* end of namespace tetris */
+//=================================================================================================================================//
+#endif
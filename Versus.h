@@ -0,0 +1,294 @@
+#ifndef VERSUS_H
+#define VERSUS_H
+//=================================================================================================================================//
+// needed header files
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "GameView.h"
+#include "EventLoop.h"
+#include "Replay.h"
+#if defined(__linux__)||defined(__linux)||defined(linux)
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/file.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#define TETRIS_VERSUS
+#endif
+//=================================================================================================================================//
+
+// namespace to contain specific assets used during gameplay
+namespace tetris
+{
+	// two games played against each other by two processes on the same machine, over a Unix domain socket. Each
+	// side sends the other every input applied to its game, so the other side plays the same game again on a
+	// shadow engine. The mini view of the opponent and the garbage its lines send are taken from that engine
+	namespace versus
+	{
+		// what a message is
+		enum class Kind : std::uint8_t {
+			Hello = 1, // the first message: the version (input), the seed (value) and randomizer (count) of the sender's game
+			Input,     // an input applied to the sender's game (input)
+			Garbage,   // rows of garbage added to the sender's game (count), with the empty cell in a column (hole)
+			Hash,      // the hash of the sender's game (value) once every message before it was applied
+			Over       // the sender's game is over, or it left
+		};
+
+		// every message is 8 bytes: the kind, three bytes whose meaning depends on it and a value (little endian)
+		struct Message {
+			Kind kind;
+			std::uint8_t input,count,hole;
+			std::uint32_t value;
+		};
+		constexpr std::size_t messageSize = 8;
+		constexpr std::uint8_t version = 1;
+
+		inline void encode(const Message& message,std::uint8_t* out) {
+			out[0] = static_cast<std::uint8_t>(message.kind); out[1] = message.input; out[2] = message.count; out[3] = message.hole;
+			for (int i = 0; i < 4; ++i) out[4+i] = static_cast<std::uint8_t>(message.value >> (8*i));
+		}
+		inline Message decode(const std::uint8_t* in) {
+			Message message{static_cast<Kind>(in[0]),in[1],in[2],in[3],0};
+			for (int i = 0; i < 4; ++i) message.value |= std::uint32_t(in[4+i]) << (8*i);
+			return message;
+		}
+
+		// rows of garbage sent for the lines one tetromino clears
+		constexpr int garbageFor[5] = {0,0,1,2,4};
+
+		// could a message have come from a game this version plays against? Inputs are ones a game applies,
+		// garbage is 1 to Board::height rows with its hole on the matrix, and the randomizer of a Hello is one
+		// that exists. Anything else means the other side is corrupt or isn't playing the same game
+		inline bool valid(const Message& message) {
+			switch (message.kind) {
+				case Kind::Hello: return message.count <= static_cast<std::uint8_t>(Randomizer::Uniform);
+				case Kind::Input: return message.input >= static_cast<std::uint8_t>(Input::Left) && message.input <= static_cast<std::uint8_t>(Input::Gravity);
+				case Kind::Garbage: return message.count > 0 && message.count <= Board::height && message.hole < Board::width;
+				case Kind::Hash: case Kind::Over: return true;
+				default: return false;
+			}
+		}
+
+		// a hash (FNV-1a) of everything that decides how a game goes on, which two engines that were given the same
+		// messages agree on
+		inline std::uint32_t hashOf(const GameEngine& engine) {
+			std::uint32_t hash = 2166136261u;
+			auto add = [&hash](const std::uint32_t& value) {
+				for (int i = 0; i < 4; ++i) { hash ^= (value >> (8*i)) & 0xff; hash *= 16777619u; }
+			};
+			for (int r = 0; r < Board::height; ++r) add(engine.getBoard().getRow(r));
+			const Piece& piece = engine.getCurrent();
+			add(static_cast<std::uint32_t>(piece.type) | (static_cast<std::uint32_t>(piece.rotation) << 8) | (static_cast<std::uint32_t>(engine.getNext()) << 16));
+			add(std::uint32_t(std::uint16_t(piece.x)) | (std::uint32_t(std::uint16_t(piece.y)) << 16));
+			add(engine.getScore()); add(engine.getLines()); add(engine.getPieces()); add(static_cast<std::uint32_t>(engine.getGarbage()));
+			return hash;
+		}
+
+#ifdef TETRIS_VERSUS
+		// the connection to the other side. Messages are kept until flush() sends them all in one write, so the
+		// messages of a tick cost one system call however many there are
+		class Link
+		{
+			public:
+			    // milliseconds the other side can go without reading before it is taken to be gone
+			    static constexpr int stallLimit = 3000;
+
+			private:
+			    int fd = -1;
+			    // messages not sent yet, and bytes received that aren't a whole message yet
+			    std::vector<std::uint8_t> out;
+			    std::uint8_t in[4096];
+			    std::size_t received = 0;
+
+			public:
+			    Link() { out.reserve(1024); } /* constructor */
+			    ~Link() { close(); } /* destructor */
+			    Link(const Link&) = delete;
+			    Link& operator=(const Link&) = delete;
+
+			    // getter methods
+			    inline int getFd() const { return this->fd; }
+			    inline bool isOpen() const { return this->fd >= 0; }
+
+			    // joins the game waiting on a socket or, if nobody is waiting, waits on it until somebody joins. Which
+			    // of the two a side does is decided while it holds a lock on path.lock, so two sides started at once
+			    // can't both find nobody waiting and each wait on a socket of its own. The socket file is removed
+			    // once the game has started and the lock file is left for the next game. Returns false if neither
+			    // worked, or a signal asked the game to stop while it waited
+			    bool open(const std::string& path) {
+			    	sockaddr_un address;
+			    	std::memset(&address,0,sizeof(address));
+			    	address.sun_family = AF_UNIX;
+			    	if (path.empty() || path.size() >= sizeof(address.sun_path)) return false;
+			    	std::memcpy(address.sun_path,path.c_str(),path.size());
+
+			    	int lock = ::open((path+".lock").c_str(),O_RDWR | O_CREAT | O_CLOEXEC,0600);
+			    	if (lock < 0) return false;
+			    	while (flock(lock,LOCK_EX) != 0) {
+			    		if (errno != EINTR || stopRequested) { ::close(lock); return false; }
+			    	}
+			    	int joining = socket(AF_UNIX,SOCK_STREAM | SOCK_CLOEXEC,0);
+			    	if (joining < 0) { ::close(lock); return false; }
+			    	if (connect(joining,reinterpret_cast<sockaddr*>(&address),sizeof(address)) == 0) { ::close(lock); return attach(joining); }
+			    	int reason = errno;
+			    	::close(joining);
+			    	// a socket file nobody answers on was left behind by a game that ended, so it can go
+			    	if (reason != ENOENT && reason != ECONNREFUSED) { ::close(lock); errno = reason; return false; }
+			    	unlink(path.c_str());
+
+			    	int listener = socket(AF_UNIX,SOCK_STREAM | SOCK_CLOEXEC,0);
+			    	bool listening = listener >= 0 && bind(listener,reinterpret_cast<sockaddr*>(&address),sizeof(address)) == 0 && listen(listener,1) == 0;
+			    	reason = errno;
+			    	// the other side can connect from here on, so it may have the lock
+			    	::close(lock);
+			    	if (!listening) {
+			    		if (listener >= 0) ::close(listener);
+			    		errno = reason; return false;
+			    	}
+			    	int joined;
+			    	while ((joined = accept(listener,nullptr,nullptr)) < 0 && errno == EINTR && !stopRequested) {}
+			    	reason = errno;
+			    	::close(listener);
+			    	unlink(path.c_str());
+			    	errno = reason;
+			    	return joined >= 0 && attach(joined);
+			    }
+
+			    // plays over a socket that is already connected
+			    bool attach(const int& socket) {
+			    	close();
+			    	fd = socket;
+			    	int flags = fcntl(fd,F_GETFL,0);
+			    	return flags >= 0 && fcntl(fd,F_SETFL,flags | O_NONBLOCK) == 0;
+			    }
+
+			    void close() {
+			    	if (fd >= 0) ::close(fd);
+			    	fd = -1; received = 0; out.clear();
+			    }
+
+			    // keeps a message to be sent with the next flush()
+			    inline void send(const Message& message) {
+			    	std::size_t size = out.size();
+			    	out.resize(size+messageSize);
+			    	encode(message,&out[size]);
+			    }
+
+			    // sends every message kept since the last flush. Returns false if the other side is gone, or has
+			    // stopped reading for stallLimit milliseconds, which is taken to be the same
+			    bool flush() {
+			    	std::size_t sent = 0;
+			    	while (sent < out.size() && fd >= 0) {
+			    		ssize_t n = ::send(fd,out.data()+sent,out.size()-sent,MSG_NOSIGNAL);
+			    		if (n > 0) { sent += n; continue; }
+			    		if (n < 0 && errno == EINTR) continue;
+			    		// the other side has fallen behind: wait a while for room rather than lose messages
+			    		if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+			    			pollfd fds[1] = {{fd,POLLOUT,0}};
+			    			int ready = poll(fds,1,stallLimit);
+			    			if (ready > 0 || (ready < 0 && errno == EINTR)) continue;
+			    		}
+			    		close(); return false;
+			    	}
+			    	out.clear();
+			    	return fd >= 0;
+			    }
+
+			    // hands every whole message that has arrived to a function, in order. Returns false once the other side
+			    // is gone
+			    template <typename Handle>
+			    bool receive(Handle handle) {
+			    	while (fd >= 0) {
+			    		std::size_t whole = received-received%messageSize;
+			    		for (std::size_t i = 0; i < whole; i += messageSize) handle(decode(in+i));
+			    		std::memmove(in,in+whole,received-whole); received -= whole;
+
+			    		ssize_t n = ::recv(fd,in+received,sizeof(in)-received,0);
+			    		if (n > 0) { received += n; continue; }
+			    		if (n < 0 && errno == EINTR) continue;
+			    		if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return true;
+			    		close();
+			    	}
+			    	return false;
+			    }
+
+			    // waits up to a number of milliseconds for the next message. Returns false if none came
+			    bool next(Message& message,const int& timeout) {
+			    	while (fd >= 0 && received < messageSize) {
+			    		pollfd fds[1] = {{fd,POLLIN,0}};
+			    		if (poll(fds,1,timeout) <= 0) return false;
+			    		ssize_t n = ::recv(fd,in+received,sizeof(in)-received,0);
+			    		if (n > 0) received += n;
+			    		else if (n == 0 || (errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK)) close();
+			    	}
+			    	if (received < messageSize) return false;
+			    	message = decode(in);
+			    	std::memmove(in,in+messageSize,received-messageSize); received -= messageSize;
+			    	return true;
+			    }
+		};
+#endif
+
+	} /* end of namespace versus */
+
+	// draws the opponent's game small in the side panel of the game page, under its score: every character is
+	// 2 rows of a column of its matrix
+	class RivalView : public GameObserver
+	{
+		public:
+		    // screen row and column of the top left character of the mini view
+		    static constexpr int top = 23, left = 47;
+
+		private:
+		    // rows of garbage the opponent's last lines send, that haven't been taken yet
+		    int attack = 0;
+
+		    void drawMini(const GameEngine& engine) {
+		    	const Board& board = engine.getBoard();
+		    	const Piece& piece = engine.getCurrent();
+		    	for (int r = 0; r < Board::height; r += 2) {
+		    		for (int c = 0; c < Board::width; ++c) {
+		    			bool upper = board.occupied(r,c),lower = board.occupied(r+1,c);
+		    			for (int i = 0; i < 4; ++i) {
+		    				if (piece.column(i) != c) continue;
+		    				if (piece.row(i) == r) upper = true;
+		    				if (piece.row(i) == r+1) lower = true;
+		    			}
+		    			renderer.put(top+r/2,left+c,upper ? (lower ? '#' : '\'') : (lower ? '.' : ' '),cyan,Normal);
+		    		}
+		    	}
+		    }
+
+		public:
+		    // draws everything, for the start of a game
+		    void redraw(const GameEngine& engine) {
+		    	for (int r = top; r < top+Board::height/2; ++r) { renderer.put(r,left-1,'|',blue,Normal); renderer.put(r,left+Board::width,'|',blue,Normal); }
+		    	drawScore(top-2,"Rival: ",engine.getScore());
+		    	drawMini(engine);
+		    }
+
+		    // shows something about the opponent in place of its score
+		    void showStatus(const std::string& status,const textColor& clr) {
+		    	renderer.fill(top-2,42,20,' ',normal,Normal);
+		    	renderer.text(top-2,52-static_cast<int>(status.length())/2,status,clr,Normal);
+		    }
+
+		    // the rows of garbage the opponent has sent since the last call
+		    inline int takeAttack() { int rows = attack; attack = 0; return rows; }
+
+		    void pieceMoved(const GameEngine& engine) { drawMini(engine); }
+		    void pieceSpawned(const GameEngine& engine) { drawMini(engine); }
+		    void linesCleared(const GameEngine& engine,int cleared) {
+		    	drawScore(top-2,"Rival: ",engine.getScore());
+		    	attack += versus::garbageFor[cleared > 4 ? 4 : cleared];
+		    }
+		    void gameOver(const GameEngine&) { showStatus("RIVAL TOPPED OUT",green); }
+	};
+
+} /* end of namespace tetris */
+//=================================================================================================================================//
+#endif
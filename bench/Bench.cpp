@@ -0,0 +1,465 @@
+// times the paths the game runs on every key press and every tick, and counts the memory they allocate
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+#include "GameView.h"
+#include "SplitScreen.h"
+#include "Versus.h"
+#include "Broadcast.h"
+#include "Replay.h"
+#include "GameUtility.h"
+#include "Bot.h"
+#include "History.h"
+#if defined(__linux__)||defined(__linux)||defined(linux)
+#include <stdlib.h> /* prototype for mkdtemp() */
+#endif
+
+// every allocation made by the program, so a benchmark can tell how many it made
+static unsigned long long allocations = 0;
+
+// every operator new and delete below goes through these two. They are kept out of line, so the compiler
+// never sees memory from operator new handed to free() and warns about it
+#if defined(__GNUC__)||defined(__clang__)
+__attribute__((noinline))
+#endif
+static void* allocate(std::size_t size,const std::size_t& alignment) {
+	++allocations;
+	if (size == 0) size = 1;
+	// aligned_alloc takes sizes that are a multiple of the alignment
+	void* memory = (alignment <= alignof(std::max_align_t)) ? std::malloc(size) : std::aligned_alloc(alignment,(size+alignment-1)/alignment*alignment);
+	if (memory == nullptr) throw std::bad_alloc();
+	return memory;
+}
+#if defined(__GNUC__)||defined(__clang__)
+__attribute__((noinline))
+#endif
+static void release(void* memory) noexcept { std::free(memory); }
+
+void* operator new(std::size_t size) { return allocate(size,0); }
+void* operator new[](std::size_t size) { return allocate(size,0); }
+void* operator new(std::size_t size,std::align_val_t alignment) { return allocate(size,static_cast<std::size_t>(alignment)); }
+void* operator new[](std::size_t size,std::align_val_t alignment) { return allocate(size,static_cast<std::size_t>(alignment)); }
+void operator delete(void* memory) noexcept { release(memory); }
+void operator delete[](void* memory) noexcept { release(memory); }
+void operator delete(void* memory,std::size_t) noexcept { release(memory); }
+void operator delete[](void* memory,std::size_t) noexcept { release(memory); }
+void operator delete(void* memory,std::align_val_t) noexcept { release(memory); }
+void operator delete[](void* memory,std::align_val_t) noexcept { release(memory); }
+void operator delete(void* memory,std::size_t,std::align_val_t) noexcept { release(memory); }
+void operator delete[](void* memory,std::size_t,std::align_val_t) noexcept { release(memory); }
+
+// namespace to contain the benchmarks
+namespace bench
+{
+	typedef std::chrono::steady_clock Clock;
+
+	// only benchmarks whose name contains this are run
+	const char* filter = "";
+
+	// stops the compiler from throwing away a result nothing reads
+	template <typename T>
+	inline void keep(const T& value) {
+#if defined(__GNUC__)||defined(__clang__)
+		asm volatile("" : : "g"(&value) : "memory");
+#else
+		static volatile const void* sink; sink = &value;
+#endif
+	}
+
+	// runs a benchmark for at least a fifth of a second and prints its time and allocations per run
+	inline bool selected(const char* name) { return std::strstr(name,filter) != nullptr; }
+
+	template <typename Function>
+	void run(const char* name,Function function) {
+		if (!selected(name)) return;
+		for (unsigned long long iterations = 1; ; iterations *= 2) {
+			unsigned long long allocated = allocations;
+			Clock::time_point start = Clock::now();
+			for (unsigned long long i = 0; i < iterations; ++i) function();
+			double elapsed = std::chrono::duration<double,std::nano>(Clock::now()-start).count();
+			allocated = allocations-allocated;
+			if (elapsed >= 2e8 || iterations >= (1ull << 32)) {
+				std::printf("%-36s %12.1f ns/op %10.2f allocs/op\n",name,elapsed/iterations,double(allocated)/iterations);
+				return;
+			}
+		}
+	}
+
+	// a board in the middle of a game: the bottom rows are filled in a random pattern with a few holes
+	tetris::Board messyBoard(const unsigned& seed) {
+		std::mt19937 random(seed);
+		tetris::Board board;
+		for (int r = tetris::Board::height-8; r < tetris::Board::height; ++r) {
+			for (int c = 0; c < tetris::Board::width; ++c) if (random()%3 != 0) board.set(r,c,1+random()%7);
+		}
+		return board;
+	}
+
+	// a board with its bottom four rows full except for column 0, and a gap in column 5 of every row
+	// that isn't meant to be cleared. A chord dropped into column 0 clears exactly the given number of lines
+	tetris::Board clearingBoard(const int& lines) {
+		tetris::Board board;
+		for (int r = tetris::Board::height-4; r < tetris::Board::height; ++r) {
+			bool clears = (tetris::Board::height-r <= lines);
+			for (int c = 1; c < tetris::Board::width; ++c) if (clears || c != 5) board.set(r,c,1);
+		}
+		return board;
+	}
+
+	// the pieces every benchmark moves around: every kind in every state, everywhere on the matrix
+	std::vector<tetris::Piece> allPlacements() {
+		std::vector<tetris::Piece> pieces;
+		for (int t = 1; t <= 7; ++t) {
+			for (int s = 0; s < 4; ++s) {
+				for (int y = 0; y < tetris::Board::height; ++y) {
+					for (int x = -1; x <= tetris::Board::width; ++x) {
+						pieces.push_back(tetris::Piece{static_cast<tetris::Type>(t),static_cast<tetris::State>(s),static_cast<std::int16_t>(x),static_cast<std::int16_t>(y)});
+					}
+				}
+			}
+		}
+		return pieces;
+	}
+
+} /* end of namespace bench */
+
+int main(int argc,char* argv[])
+{
+	using namespace tetris;
+	if (argc > 1) bench::filter = argv[1];
+
+	const Board board = bench::messyBoard(1);
+	const std::vector<Piece> pieces = bench::allPlacements();
+	std::size_t next = 0;
+
+	bench::run("collision/fits",[&]() {
+		bench::keep(fits(board,pieces[next]));
+		if (++next == pieces.size()) next = 0;
+	});
+
+	bench::run("collision/drop distance",[&]() {
+		const Piece& piece = pieces[next];
+		if (fits(board,piece)) bench::keep(dropDistance(board,piece));
+		if (++next == pieces.size()) next = 0;
+	});
+
+	// a game with some blocks on the matrix, where the falling tetromino is free to turn
+	GameEngine engine(1);
+	engine.setBoard(board);
+	bench::run("rotation/classic kicks",[&]() { engine.step(Action::Rotate); });
+	engine.setKicks(srsKickTable);
+	bench::run("rotation/srs kicks",[&]() { engine.step(Action::Rotate); });
+
+	// a turn next to a wall, where the kicks have to be tried
+	engine.setKicks(classicKickTable);
+	engine.setCurrent(Piece{Type::Chord,State::Right,-1,2});
+	bench::run("rotation/wall kick",[&]() { engine.step(Action::Rotate); });
+
+	// a hard drop from the top of the matrix, landing the tetromino and bringing in the next one
+	GameEngine dropping(1);
+	bench::run("hard drop/lock and spawn",[&]() {
+		dropping.setBoard(board);
+		dropping.setCurrent(Piece::spawn(Type::TBlock));
+		dropping.step(Action::Drop);
+	});
+
+	// a chord dropped into the gap of full rows, clearing 1 to 4 lines at once
+	const char* clearNames[4] = {"checkLine/1 line","checkLine/2 lines","checkLine/3 lines","checkLine/4 lines"};
+	for (int lines = 1; lines <= 4; ++lines) {
+		const Board full = bench::clearingBoard(lines);
+		GameEngine clearing(1);
+		bench::run(clearNames[lines-1],[&]() {
+			clearing.setBoard(full);
+			clearing.setCurrent(Piece{Type::Chord,State::Right,-1,Board::height-3});
+			clearing.step(Action::Drop);
+		});
+	}
+
+	// the same lines cleared on their own, from the board the chord has landed on
+	const char* sweepNames[4] = {"clearLines/1 line","clearLines/2 lines","clearLines/3 lines","clearLines/4 lines"};
+	for (int lines = 1; lines <= 4; ++lines) {
+		Board landed = bench::clearingBoard(lines);
+		const Piece chord{Type::Chord,State::Right,-1,Board::height-3};
+		place(landed,chord.moved(dropDistance(landed,chord),0));
+		bench::run(sweepNames[lines-1],[&]() {
+			Board cleared = landed;
+			bench::keep(clearLines(cleared,chord.moved(dropDistance(landed,chord),0)));
+			bench::keep(cleared);
+		});
+	}
+
+	// picking the next shape the way the game does, with either randomizer, and a whole queue at a time the way
+	// a game without a screen can
+	PieceGenerator bagGenerator(1,Randomizer::Bag),uniformGenerator(1,Randomizer::Uniform);
+	bench::run("shapes/generate 7-bag",[&]() { bench::keep(Piece::spawn(bagGenerator.next())); });
+	bench::run("shapes/generate uniform",[&]() { bench::keep(Piece::spawn(uniformGenerator.next())); });
+	std::mt19937 randomEngine(1);
+	std::uniform_int_distribution<int> dist(0,6);
+	bench::run("shapes/generate mt19937 (before)",[&]() {
+		bench::keep(Piece::spawn(static_cast<Type>(dist(randomEngine)+1)));
+	});
+	Type queue[1024];
+	bench::run("shapes/fill 1024 7-bag",[&]() { bagGenerator.fill(queue,1024); bench::keep(queue[1023]); });
+
+	// the bot picking a placement for the falling tetromino, which it has to do well within one gravity interval
+	Bot bot;
+	GameEngine deciding(1);
+	deciding.setBoard(board);
+	bench::run("bot/choose placement",[&]() { bench::keep(bot.choose(deciding)); });
+
+	// measuring the matrices every placement of a tetromino leaves, the way the bot does, one at a time and with
+	// every kind of vector unit the processor has
+	BoardBatch batch;
+	for (int c = 0; batch.count < 34; c = (c+1)%Board::width) {
+		Board after = board;
+		Piece piece = Piece{Type::Chord,static_cast<State>(batch.count%2),static_cast<std::int16_t>(c-1),0};
+		if (fits(after,piece)) place(after,piece.moved(dropDistance(after,piece),0));
+		batch.add(after);
+	}
+	FeatureBatch features;
+	bench::run("features/scalar (34 boards)",[&]() { measureScalar(batch,features); bench::keep(features); });
+#ifdef TETRIS_SIMD
+	if (__builtin_cpu_supports("popcnt")) bench::run("features/scalar, popcnt (34 boards)",[&]() { measurePopcnt(batch,features); bench::keep(features); });
+	if (__builtin_cpu_supports("sse4.2")) bench::run("features/sse4.2 (34 boards)",[&]() { measureSse42(batch,features); bench::keep(features); });
+	if (__builtin_cpu_supports("avx2")) bench::run("features/avx2 (34 boards)",[&]() { measureAvx2(batch,features); bench::keep(features); });
+#endif
+
+	// drawing a game into the renderer and collecting the bytes it would send, instead of writing them out
+	GameEngine playing(1);
+	playing.setBoard(board);
+	std::string sink;
+	sink.reserve(1 << 20);
+	bench::run("render/full frame",[&]() {
+		renderer.invalidate();
+		drawMatrix(playing); drawNextShape(playing); updateScores(playing);
+		sink += renderer.present();
+		if (sink.size() > (1u << 19)) sink.clear();
+	});
+	bool left = true;
+	bench::run("render/frame after a move",[&]() {
+		playing.step((left = !left) ? Action::Left : Action::Right);
+		drawMatrix(playing);
+		sink += renderer.present();
+		if (sink.size() > (1u << 19)) sink.clear();
+	});
+
+	// a frame of the split screen with all 8 boards, after the tetromino moved on every one of them
+	std::vector<std::unique_ptr<SplitBoard>> splitBoards;
+	for (int i = 0; i < maxBoards; ++i) {
+		splitBoards.emplace_back(new SplitBoard(i,1+i,Randomizer::Bag,true,"Bot"));
+		splitBoards.back()->engine.setBoard(board);
+	}
+	renderer.invalidate();
+	for (const std::unique_ptr<SplitBoard>& split : splitBoards) split->view.redraw(split->engine);
+	renderer.present();
+	bench::run("render/split screen, 8 boards moved",[&]() {
+		left = !left;
+		for (const std::unique_ptr<SplitBoard>& split : splitBoards) split->press(left ? '4' : '6');
+		sink += renderer.present();
+		if (sink.size() > (1u << 19)) sink.clear();
+	});
+	renderer.invalidate();
+
+#ifdef TETRIS_VERSUS
+	// the messages of a tick going to the other side of a versus game and its answer coming back, over a pair of
+	// connected Unix domain sockets, with the other side playing the inputs on its shadow engine. This is what
+	// versus adds to the time it takes an input to show on the other screen
+	int sockets[2];
+	if (bench::selected("versus/tick of 4 messages, round trip") && socketpair(AF_UNIX,SOCK_STREAM,0,sockets) == 0) {
+		versus::Link near,far;
+		near.attach(sockets[0]); far.attach(sockets[1]);
+		GameEngine shadow(1);
+		unsigned handled = 0;
+		auto count = [&](const versus::Message& message) {
+			if (message.kind == versus::Kind::Input) apply(shadow,static_cast<Input>(message.input));
+			else if (message.kind == versus::Kind::Hash) bench::keep(versus::hashOf(shadow));
+			++handled;
+		};
+		bench::run("versus/tick of 4 messages, round trip",[&]() {
+			left = !left;
+			near.send(versus::Message{versus::Kind::Input,static_cast<std::uint8_t>(left ? Input::Left : Input::Right),0,0,0});
+			near.send(versus::Message{versus::Kind::Input,static_cast<std::uint8_t>(Input::Rotate),0,0,0});
+			near.send(versus::Message{versus::Kind::Input,static_cast<std::uint8_t>(Input::Gravity),0,0,0});
+			near.send(versus::Message{versus::Kind::Hash,0,0,0,0});
+			near.flush();
+			for (handled = 0; handled < 4; ) far.receive(count);
+			far.send(versus::Message{versus::Kind::Hash,0,0,0,0});
+			far.flush();
+			for (handled = 0; handled < 1; ) near.receive(count);
+			if (shadow.isOver()) shadow.reset(1);
+		});
+	}
+#endif
+
+#ifdef TETRIS_BROADCAST
+	// a tick of a broadcast game: the tetromino moved and its record sent to 256 spectators, one write each. The
+	// spectators read what they were sent every 256 ticks, as spectators that keep up do, which is timed too
+	char spectatorFolder[] = "/tmp/tetris-bench-XXXXXX";
+	if (bench::selected("broadcast/tick to 256 spectators") && mkdtemp(spectatorFolder) != nullptr) {
+		std::string path = std::string(spectatorFolder)+"/game.sock";
+		Broadcast broadcast;
+		std::vector<int> watchers;
+		if (broadcast.open(path)) {
+			sockaddr_un address;
+			std::memset(&address,0,sizeof(address));
+			address.sun_family = AF_UNIX;
+			std::memcpy(address.sun_path,path.c_str(),path.size());
+			for (int i = 0; i < 256; ++i) {
+				int fd = socket(AF_UNIX,SOCK_STREAM,0);
+				if (fd >= 0 && connect(fd,reinterpret_cast<sockaddr*>(&address),sizeof(address)) == 0) watchers.push_back(fd);
+				else if (fd >= 0) close(fd);
+				// the socket only keeps so many spectators waiting to be taken
+				if (i%64 == 63) broadcast.accept();
+			}
+			GameEngine game(1);
+			game.setObserver(&broadcast);
+			broadcast.start(game,1); broadcast.flush();
+			std::uint8_t drained[4096];
+			unsigned ticks = 0;
+			bench::run("broadcast/tick to 256 spectators",[&]() {
+				left = !left;
+				game.step(left ? Action::Left : Action::Right);
+				broadcast.flush();
+				if (++ticks%256 == 0) for (int fd : watchers) while (recv(fd,drained,sizeof(drained),MSG_DONTWAIT) > 0) {}
+			});
+		}
+		for (int fd : watchers) close(fd);
+		broadcast.close();
+		rmdir(spectatorFolder);
+	}
+#endif
+
+	// the sequences that move the cursor and set the color, as cursor() and color() make them now and the way
+	// cursor() used to build a string for every one
+	int row = 0;
+	bench::run("escape/cursor",[&]() { bench::keep(cursor(3+row,7+2*row)); row = (row+1)%32; });
+	bench::run("escape/cursor, to_string (before)",[&]() {
+		bench::keep(std::string("\033["+std::to_string(3+row)+";"+std::to_string(7+2*row)+"H")); row = (row+1)%32;
+	});
+	const textColor colors[4] = {green,white,cyan,normal};
+	bench::run("escape/color",[&]() { bench::keep(color(colors[row],(row == 1) ? Red : Normal)); row = (row+1)%4; });
+
+	// what the game does for every key pressed while playing: move the tetromino, draw the matrix and put the
+	// changed cells, the cursor and the color into the frame. None of it should allocate
+	bench::run("keystroke/move, render and print",[&]() {
+		std::size_t mark = frame.getSize();
+		playing.step((left = !left) ? Action::Left : Action::Right);
+		drawMatrix(playing);
+		const std::string& cells = renderer.present();
+		if (!cells.empty()) frame << cells << cursor() << color();
+		frame.cut(mark);
+	});
+	// and for every key pressed on the menu: move the selector to the next option
+	Selector selector(21,11,38,11,23);
+	const std::string* options = screen.getOptions(0);
+	const int* optionsCols = screen.getOptionsCols(0);
+	bench::run("keystroke/menu selector move",[&]() {
+		std::size_t mark = frame.getSize();
+		selector.erase();
+		selector.scroll((selector.getRow() < selector.getLowerLimit()) ? '8' : '2');
+		if (selector.getRow() == selector.getLowerLimit()) selector.reset();
+		selector.indicateOption(options[selector.getCount()],optionsCols[selector.getCount()]);
+		frame << cursor();
+		frame.cut(mark);
+	});
+	bench::run("keystroke/display",[&]() {
+		std::size_t mark = frame.getSize();
+		screen.display(options[row],11+3*row,12,cyan); row = (row+1)%5;
+		frame.cut(mark);
+	});
+
+	// switching to a page the way it used to be done, erasing the screen a line at a time the way Screen::clear()
+	// used to and drawing the page through display(), and by showing the page kept the first time it was drawn
+	struct PageBench { const char* drawn; const char* kept; CachedPage* page; void (*draw)(); };
+	const PageBench pageBenches[4] = {
+		{"pages/menu, drawn","pages/menu, kept",&interface::menuPage,interface::drawMenu},
+		{"pages/difficulty, drawn","pages/difficulty, kept",&interface::difficultyPage,interface::drawDifficulty},
+		{"pages/instructions, drawn","pages/instructions, kept",&interface::instructionsPage,interface::drawInstructions},
+		{"pages/settings, drawn","pages/settings, kept",&interface::settingsPage,interface::drawSettings}
+	};
+	for (const PageBench& pageBench : pageBenches) {
+		std::size_t mark = frame.getSize(),drawnBytes = 0,keptBytes = 0;
+		bench::run(pageBench.drawn,[&]() {
+			for (int y = 33; y >= 3; y--) frame << cursor(y,7) << color() << std::string(55,' ') << cursor();
+			pageBench.draw();
+			drawnBytes = frame.getSize()-mark; frame.cut(mark);
+		});
+		interface::showPage(*pageBench.page,pageBench.draw);
+		frame.cut(mark);
+		bench::run(pageBench.kept,[&]() {
+			screen.clear(); pageBench.page->show();
+			keptBytes = frame.getSize()-mark; frame.cut(mark);
+		});
+		if (drawnBytes > 0 && keptBytes > 0) std::printf("%-36s %zu bytes drawn, %zu bytes kept\n",pageBench.kept,drawnBytes,keptBytes);
+	}
+	bench::run("pages/scores, kept and patched",[&]() {
+		std::size_t mark = frame.getSize();
+		screen.clear(); interface::scores();
+		frame.cut(mark);
+	});
+
+	// a trace span when no trace is being recorded, which every span the game runs through costs, and 1000 of
+	// them while one is, next to the two timestamps every recorded span reads
+	bench::run("trace/span, not recording",[&]() { TRACE_SCOPE("bench"); bench::keep(sink); });
+	bench::run("trace/1000 pairs of timestamps",[&]() {
+		std::uint64_t ticks = 0;
+		for (int i = 0; i < 1000; ++i) { std::uint64_t begin = trace::now(); ticks += trace::now()-begin; }
+		bench::keep(ticks);
+	});
+	trace::start("");
+	bench::run("trace/1000 spans, recording",[&]() {
+		for (int i = 0; i < 1000; ++i) { TRACE_SCOPE("bench"); }
+		trace::discard();
+	});
+	trace::enabled = false;
+	trace::discard();
+
+	// saving and loading the scores, in a folder of their own so the player's scores are left alone
+	std::string folder = "";
+#if defined(__linux__)||defined(__linux)||defined(linux)
+	char name[] = "/tmp/tetris_bench.XXXXXX";
+	if (mkdtemp(name) != nullptr) folder = std::string(name)+"/";
+#endif
+	Data data;
+	data.setFolder(folder);
+	data.setHighestScore(1234); data.setHighestLines(56);
+	bench::run("save file/store",[&]() { data.createGameData(); });
+	bench::run("save file/load",[&]() { data.retrieveGameData(); });
+	std::remove((folder+"tetris.dat").c_str());
+
+	// the game history with 100k games in it: adding a game, opening it again and asking it what the scores
+	// page shows, none of which should depend on how many games there are
+	if (bench::selected("history/add game") || bench::selected("history/open 100k games") || bench::selected("history/scores page queries")) {
+		History history;
+		history.open(folder);
+		GameRecord game;
+		std::mt19937 random(1);
+		bench::run("history/add game",[&]() {
+			game.score = random()%5000; game.lines = game.score/30; game.level = 1+random()%6;
+			history.add(game);
+		});
+		while (history.getGames() < 100000) { game.score = random()%5000; game.level = 1+random()%6; history.add(game); }
+		history.close();
+		bench::run("history/open 100k games",[&]() { history.open(folder); bench::keep(history.getGames()); });
+		bench::run("history/scores page queries",[&]() {
+			unsigned sum = history.percentile(50)+history.percentile(90);
+			for (int i = 0; i < 5 && i < history.getTopCount(2); ++i) sum += history.getTop(2,i).score;
+			for (int i = 0; i < 5 && i < history.getRecentCount(); ++i) sum += history.getRecent(i).score;
+			bench::keep(sum);
+		});
+		std::printf("%-36s %llu games, median %u, top 10%% %u\n","history/",static_cast<unsigned long long>(history.getGames()),history.percentile(50),history.percentile(90));
+	}
+	std::remove((folder+"history.log").c_str());
+	std::remove((folder+"history.idx").c_str());
+#if defined(__linux__)||defined(__linux)||defined(linux)
+	if (!folder.empty()) rmdir(folder.c_str());
+#endif
+	return 0;
+}
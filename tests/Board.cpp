@@ -0,0 +1,160 @@
+// checks a board against a plain model of the same matrix, one bool and one kind per cell: random blocks, line
+// clears and garbage are played on both, and after every step the rows, the column masks, the surface and the
+// depth under cells must agree with the model
+#include <memory>
+#include <random>
+#include <vector>
+#include "Board.h"
+#include "Check.h"
+
+namespace
+{
+	using namespace tetris;
+
+	template <int Width,int Height>
+	struct Model {
+		std::vector<bool> taken = std::vector<bool>(Width*Height,false);
+		std::vector<std::uint8_t> kinds = std::vector<std::uint8_t>(Width*Height,0);
+
+		bool at(const int& row,const int& column) const { return taken[row*Width+column]; }
+		void set(const int& row,const int& column,const std::uint8_t& kind) { taken[row*Width+column] = true; kinds[row*Width+column] = kind; }
+
+		bool full(const int& row) const {
+			for (int c = 0; c < Width; ++c) if (!at(row,c)) return false;
+			return true;
+		}
+		// the highest row with a block on it, height when the matrix is empty
+		int top() const {
+			for (int r = 0; r < Height; ++r) for (int c = 0; c < Width; ++c) if (at(r,c)) return r;
+			return Height;
+		}
+
+		// takes a row out and drops everything above it by one
+		void remove(const int& row) {
+			taken.erase(taken.begin()+row*Width,taken.begin()+(row+1)*Width);
+			taken.insert(taken.begin(),Width,false);
+			kinds.erase(kinds.begin()+row*Width,kinds.begin()+(row+1)*Width);
+			kinds.insert(kinds.begin(),Width,0);
+		}
+		// pushes everything up by a number of rows and puts garbage under it. Returns false if blocks went off the top
+		bool raise(const int& count,const int& hole,const std::uint8_t& kind) {
+			bool fits = true;
+			for (int i = 0; i < count*Width; ++i) if (taken[i]) fits = false;
+			taken.erase(taken.begin(),taken.begin()+count*Width);
+			kinds.erase(kinds.begin(),kinds.begin()+count*Width);
+			for (int r = 0; r < count; ++r) for (int c = 0; c < Width; ++c) {
+				taken.push_back(c != hole);
+				kinds.push_back(c == hole ? 0 : kind);
+			}
+			return fits;
+		}
+	};
+
+	template <int Width,int Height>
+	void compare(const BasicBoard<Width,Height>& board,const Model<Width,Height>& model,const bool& exact) {
+		typedef BasicBoard<Width,Height> Matrix;
+		typedef typename Matrix::Row Row;
+		typedef typename Matrix::Word Word;
+
+		CHECK(board.getRow(-1) == Matrix::fullRow && board.getRow(Height) == Matrix::fullRow);
+		for (int r = 0; r < Height; ++r) {
+			Row row = Matrix::emptyRow;
+			for (int c = 0; c < Width; ++c) {
+				if (model.at(r,c)) row |= Matrix::bit(c);
+				if (model.at(r,c) && board.getKind(r,c) != model.kinds[r*Width+c]) { CHECK(board.getKind(r,c) == model.kinds[r*Width+c]); return; }
+			}
+			if (board.getRow(r) != row) { CHECK(board.getRow(r) == row); return; }
+			CHECK(board.rowIsFull(r) == model.full(r));
+		}
+
+		// every word of every column, the bottom border included and nothing past it
+		for (int c = 0; c < Width; ++c) {
+			for (int w = 0; w < Matrix::words; ++w) {
+				Word column = 0;
+				for (int b = 0; b < Matrix::wordBits; ++b) {
+					int r = w*Matrix::wordBits+b;
+					if (r == Height || (r < Height && model.at(r,c))) column |= Word(Word(1u) << b);
+				}
+				if (board.getColumn(c,w) != column) { CHECK(board.getColumn(c,w) == column); return; }
+			}
+		}
+
+		// the surface is the highest block, except after blocks were pushed off the top (the game is over then),
+		// when it only has to have no block above it
+		int top = model.top();
+		if (exact) CHECK(board.getSurface() == top);
+		else CHECK(board.getSurface() <= top);
+
+		// the empty cells under every cell, counted up each column from the bottom border
+		for (int c = 0; c < Width; ++c) {
+			int depth = 0;
+			for (int r = Height-1; r >= -1; --r) {
+				if (board.depth(r,c) != depth) { CHECK(board.depth(r,c) == depth); return; }
+				depth = (r >= 0 && model.at(r,c)) ? 0 : depth+1;
+			}
+		}
+	}
+
+	// plays a number of random sequences of some steps each on a board and its model
+	template <int Width,int Height>
+	void play(const unsigned& seed,const int& sequences,const int& steps) {
+		std::mt19937 random(seed);
+		auto board = std::make_unique<BasicBoard<Width,Height>>();
+		for (int s = 0; s < sequences; ++s) {
+			board->reset();
+			Model<Width,Height> model;
+			bool exact = true;
+			for (int step = 0; step < steps; ++step) {
+				int top = model.top(),what = static_cast<int>(random()%4);
+				if (what == 0) {
+					// a few blocks on the row over the highest one or under it: in a game the rows with blocks on them
+					// are always one band at the bottom, with no empty row in it
+					for (int n = 1+random()%4; n > 0; --n) {
+						int low = (top > 0) ? top-1 : 0,r = low+static_cast<int>(random()%(Height-low)),c = static_cast<int>(random()%Width);
+						std::uint8_t kind = static_cast<std::uint8_t>(1+random()%7);
+						board->set(r,c,kind); model.set(r,c,kind);
+					}
+				} else if (what == 1) {
+					// fills some rows in a window of up to 32 and clears every full row of it, as a lock does
+					int first = static_cast<int>(random()%Height);
+					int span = (Height-first < 32) ? Height-first : 32;
+					for (int n = random()%3; n > 0; --n) {
+						int r = first+static_cast<int>(random()%span);
+						if (r >= top) for (int c = 0; c < Width; ++c) if (!model.at(r,c)) { board->set(r,c,1); model.set(r,c,1); }
+					}
+					std::uint32_t cleared = 0;
+					for (int i = 0; i < span; ++i) if (model.full(first+i)) cleared |= std::uint32_t(1u) << i;
+					board->clearRows(first,cleared);
+					for (int i = 0; i < span; ++i) if (cleared & (std::uint32_t(1u) << i)) model.remove(first+i);
+				} else if (what == 2) {
+					// garbage, now and then more rows than the matrix has
+					int count = 1+static_cast<int>(random()%((random()%16 == 0) ? Height+4 : 4)),hole = static_cast<int>(random()%Width);
+					int rows = (count > Height) ? Height : count;
+					bool fits = model.raise(rows,hole,8);
+					CHECK(board->raise(count,hole,8) == fits);
+					// an empty garbage row (one column with the hole) doesn't count as a block, and once the surface is
+					// above the highest block it stays so until the matrix is emptied
+					exact = exact && fits && Width > 1;
+				} else if (random()%64 == 0) {
+					board->reset();
+					model = Model<Width,Height>();
+					exact = true;
+				}
+				compare(*board,model,exact);
+				if (check::failures > 0) return;
+			}
+		}
+	}
+
+} /* end of anonymous namespace */
+
+int main()
+{
+	play<10,20>(1,2000,60);
+	play<1,5>(2,500,40);
+	play<16,31>(3,500,60);
+	play<32,64>(4,300,80);
+	play<62,64>(5,200,80);
+	play<64,4096>(6,4,150);
+	return check::result();
+}
@@ -0,0 +1,187 @@
+// checks what spectators are sent: that records that can't be right are turned down, that every spectator's
+// picture is the game being played after every flush, spectators joining late included, and that a spectator
+// that stops reading is sent a keyframe and then let go without holding the others up
+#include <random>
+#include <vector>
+#include "Bot.h"
+#include "Broadcast.h"
+#include "Replay.h"
+#include "Check.h"
+
+namespace
+{
+	using namespace tetris;
+	using spectate::Kind;
+	using spectate::Record;
+
+	// the matrix and the scores, which is all that is left to compare once the game is over: the tetromino
+	// that didn't fit is never sent
+	bool sameMatrix(const spectate::Picture& picture,const GameEngine& engine) {
+		for (int r = 0; r < Board::height; ++r) {
+			if (picture.board.getRow(r) != engine.getBoard().getRow(r)) return false;
+			for (int c = 0; c < Board::width; ++c) {
+				if (engine.getBoard().occupied(r,c) && picture.board.getKind(r,c) != engine.getBoard().getKind(r,c)) return false;
+			}
+		}
+		return picture.synced && picture.score == engine.getScore() && picture.lines == engine.getLines();
+	}
+	bool same(const spectate::Picture& picture,const GameEngine& engine) {
+		const Piece& a = picture.current,&b = engine.getCurrent();
+		return sameMatrix(picture,engine) && a.type == b.type && a.rotation == b.rotation && a.x == b.x && a.y == b.y
+		    && picture.next == engine.getNext();
+	}
+
+	void checkRecords() {
+		std::uint8_t bytes[spectate::recordSize];
+		Record sent{Kind::Score,1,2,3,0x01020304u,0xa0b0c0d0u};
+		spectate::encode(sent,bytes);
+		Record got = spectate::decode(bytes);
+		CHECK(got.kind == sent.kind && got.a == 1 && got.b == 2 && got.c == 3 && got.value == sent.value && got.extra == sent.extra);
+
+		spectate::Picture picture;
+		// before the first keyframe records are skipped, and ones that don't exist are turned down
+		CHECK(picture.apply(Record{Kind::Score,0,0,0,5,1}) && picture.score == 0);
+		CHECK(!picture.apply(Record{static_cast<Kind>(9),0,0,0,0,0}));
+		CHECK(picture.apply(Record{Kind::Keyframe,3,0,0,100,4}) && picture.synced && picture.level == 3 && picture.score == 100);
+
+		const Record wrong[] = {
+			Record{Kind::Row,Board::height,0,0,0,0},                                                       // a row off the matrix
+			Record{Kind::Row,0,0,0,0x9u,0},                                                                // a cell kind past garbage's
+			Record{Kind::Spawned,8,0,0,4,0},                                                               // a shape that doesn't exist
+			Record{Kind::Spawned,static_cast<std::uint8_t>(Type::TBlock),0,8,4,0},                         // a next shape that doesn't exist
+			spectate::pieceRecord(Kind::Moved,Piece{Type::Chord,State::Up,8,0}),                           // blocks past the right wall
+			spectate::pieceRecord(Kind::Locked,Piece{Type::TBlock,State::Up,4,Board::height-1}),          // blocks under the matrix
+			Record{static_cast<Kind>(0),0,0,0,0,0}
+		};
+		for (const Record& record : wrong) {
+			picture.apply(Record{Kind::Keyframe,0,0,0,0,0});
+			CHECK(!picture.apply(record) && !picture.synced);
+		}
+		// a picture out of step skips the rest until a keyframe
+		CHECK(picture.apply(Record{Kind::Score,0,0,0,7,7}) && picture.score == 0);
+		CHECK(picture.apply(Record{Kind::Keyframe,0,0,0,0,0}) && picture.synced);
+		CHECK(picture.apply(spectate::pieceRecord(Kind::Spawned,Piece::spawn(Type::TBlock),Type::Square)) && picture.next == Type::Square);
+	}
+
+#ifdef TETRIS_BROADCAST
+	// a spectator as a tool would be one: a socket and the picture it puts together
+	struct Spectator {
+		int fd;
+		std::vector<std::uint8_t> bytes;
+		spectate::Picture picture;
+		int rejected = 0;
+
+		explicit Spectator(const std::string& path): fd(socket(AF_UNIX,SOCK_STREAM | SOCK_CLOEXEC,0)) {
+			sockaddr_un address;
+			std::memset(&address,0,sizeof(address));
+			address.sun_family = AF_UNIX;
+			std::memcpy(address.sun_path,path.c_str(),path.size());
+			if (fd >= 0 && connect(fd,reinterpret_cast<sockaddr*>(&address),sizeof(address)) != 0) { ::close(fd); fd = -1; }
+		}
+		// applies every whole record waiting on the socket
+		void read() {
+			std::uint8_t buffer[1 << 16];
+			ssize_t n;
+			while ((n = recv(fd,buffer,sizeof(buffer),MSG_DONTWAIT)) > 0) bytes.insert(bytes.end(),buffer,buffer+n);
+			std::size_t whole = bytes.size()-bytes.size()%spectate::recordSize;
+			for (std::size_t i = 0; i < whole; i += spectate::recordSize) if (!picture.apply(spectate::decode(&bytes[i]))) ++rejected;
+			bytes.erase(bytes.begin(),bytes.begin()+static_cast<long>(whole));
+		}
+	};
+
+	// many spectators, one of which leaves and one of which joins late, watch games played with random inputs
+	void checkWatchers(const std::string& path,const int& count) {
+		Broadcast broadcast;
+		CHECK(broadcast.open(path));
+		// a second game can't take the socket while this one is on it. The connection it tried with is taken as a
+		// spectator, and let go the first time it is sent something
+		Broadcast other;
+		CHECK(!other.open(path));
+
+		std::vector<Spectator> spectators;
+		spectators.reserve(count+1);
+		for (int i = 0; i < count; ++i) {
+			spectators.emplace_back(path);
+			if (i%50 == 49) broadcast.accept();
+		}
+		broadcast.accept();
+		CHECK(broadcast.getSpectators() == static_cast<std::size_t>(count)+1);
+
+		// the tetromino mostly moves and falls, so a game lasts long enough to be joined
+		const Input inputs[] = {Input::Left,Input::Right,Input::Rotate,Input::Gravity,Input::Gravity,Input::Gravity};
+		std::mt19937 random(17);
+		int mismatches = 0;
+		for (int game = 0; game < 3; ++game) {
+			GameEngine engine(100+game);
+			engine.setObserver(&broadcast);
+			broadcast.start(engine,game);
+			if (game == 1) { ::close(spectators[0].fd); spectators[0].fd = -1; }
+			for (int step = 0; !engine.isOver(); ++step) {
+				apply(engine,(random()%12 == 0) ? Input::Drop : inputs[random()%6]);
+				broadcast.flush();
+				if (game == 2 && step == 40) { spectators.emplace_back(path); broadcast.accept(); }
+				if (step%5 != 0) continue;
+				for (Spectator& spectator : spectators) {
+					if (spectator.fd < 0) continue;
+					spectator.read();
+					if (!same(spectator.picture,engine)) ++mismatches;
+				}
+			}
+			broadcast.finish();
+			for (Spectator& spectator : spectators) {
+				if (spectator.fd < 0) continue;
+				spectator.read();
+				CHECK(sameMatrix(spectator.picture,engine) && spectator.picture.over);
+			}
+		}
+		CHECK(mismatches == 0);
+		for (const Spectator& spectator : spectators) CHECK(spectator.rejected == 0);
+		CHECK(broadcast.getDropped() == 2 && broadcast.getResynced() == 0);
+		CHECK(broadcast.getSpectators() == static_cast<std::size_t>(count));
+		for (Spectator& spectator : spectators) if (spectator.fd >= 0) ::close(spectator.fd);
+	}
+
+	// a spectator that never reads is sent a keyframe once it owes too much, then let go when it falls behind
+	// again, while one that reads stays in step
+	void checkLazy(const std::string& path) {
+		Broadcast broadcast;
+		CHECK(broadcast.open(path));
+		Spectator reader(path),lazy(path);
+		broadcast.accept();
+		CHECK(broadcast.getSpectators() == 2);
+
+		Bot bot;
+		int mismatches = 0;
+		for (int game = 0; game < 50 && broadcast.getSpectators() == 2; ++game) {
+			GameEngine engine(7+game);
+			engine.setObserver(&broadcast);
+			broadcast.start(engine,1);
+			while (!engine.isOver() && engine.getPieces() < 2000 && broadcast.getSpectators() == 2) {
+				for (const char& key : bot.keys(bot.choose(engine))) {
+					apply(engine,key == '4' ? Input::Left : key == '6' ? Input::Right : key == '5' ? Input::Rotate : Input::Drop);
+					broadcast.flush();
+					reader.read();
+					if (!same(reader.picture,engine)) ++mismatches;
+				}
+			}
+			broadcast.finish();
+		}
+		CHECK(mismatches == 0 && reader.rejected == 0);
+		CHECK(broadcast.getResynced() >= 1 && broadcast.getDropped() == 1 && broadcast.getSpectators() == 1);
+		::close(reader.fd); ::close(lazy.fd);
+	}
+#endif
+
+} /* end of anonymous namespace */
+
+int main()
+{
+	checkRecords();
+#ifdef TETRIS_BROADCAST
+	std::string folder = check::folder(),path = folder+"watch.sock";
+	checkWatchers(path,300);
+	checkLazy(path);
+	check::removeFolder(folder);
+#endif
+	return check::result();
+}
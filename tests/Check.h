@@ -0,0 +1,52 @@
+#ifndef CHECK_H
+#define CHECK_H
+//=================================================================================================================================//
+// needed header files
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#if defined(__linux__)||defined(__linux)||defined(linux)
+#include <unistd.h>
+#endif
+//=================================================================================================================================//
+
+// what every test program checks with: CHECK() reports a condition that doesn't hold with where it is and carries
+// on, and a test program returns check::result() so ctest sees whether any failed
+namespace check
+{
+	inline int failures = 0;
+
+	inline void fail(const char* file,const int& line,const char* condition) {
+		std::fprintf(stderr,"%s:%d: %s doesn't hold\n",file,line,condition);
+		++failures;
+	}
+
+	// 0 if every check held. Prints how many didn't
+	inline int result() {
+		if (failures > 0) std::fprintf(stderr,"%d checks failed\n",failures);
+		return failures > 0 ? 1 : 0;
+	}
+
+	// a new empty folder for the files a test writes, ending with a '/'. Other systems use the current folder
+	inline std::string folder() {
+#if defined(__linux__)||defined(__linux)||defined(linux)
+		char path[] = "/tmp/tetris-test-XXXXXX";
+		if (mkdtemp(path) != nullptr) return std::string(path)+"/";
+#endif
+		return "";
+	}
+	// removes a folder from folder() once the files in it are removed
+	inline void removeFolder(const std::string& folder) {
+#if defined(__linux__)||defined(__linux)||defined(linux)
+		if (!folder.empty()) rmdir(folder.c_str());
+#else
+		(void)folder;
+#endif
+	}
+
+} /* end of namespace check */
+
+#define CHECK(condition) do { if (!(condition)) check::fail(__FILE__,__LINE__,#condition); } while (false)
+
+//=================================================================================================================================//
+#endif
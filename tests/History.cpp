@@ -0,0 +1,142 @@
+// checks the game history: that the index answers the same as working the answers out from every game played,
+// that it is kept across runs and made again from the log when it is lost, and that damaged records and a
+// record cut off at the end of the log are dropped
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "History.h"
+#include "Check.h"
+
+namespace
+{
+	using namespace tetris;
+
+	GameRecord game(std::mt19937& random,const std::uint32_t& n) {
+		GameRecord record;
+		// mostly small scores, with now and then a big one so every range of the histogram is used
+		record.score = (random()%8 == 0) ? static_cast<std::uint32_t>(random()) : static_cast<std::uint32_t>(random()%5000);
+		record.lines = n; record.pieces = 2*n; record.seed = static_cast<std::uint32_t>(random());
+		record.duration = 1000*n; record.time = 1700000000u+n;
+		record.level = static_cast<std::uint8_t>(random()%9);
+		record.randomizer = static_cast<std::uint8_t>(random()%2);
+		return record;
+	}
+
+	// the answers worked out from every game
+	void compare(const History& history,const std::vector<GameRecord>& games) {
+		CHECK(history.getGames() == games.size());
+		for (int level = 0; level < HistoryIndex::levels; ++level) {
+			// games of levels past the last are counted with the last
+			std::vector<std::uint32_t> scores;
+			for (const GameRecord& g : games) if ((g.level < HistoryIndex::levels ? g.level : HistoryIndex::levels-1) == level) scores.push_back(g.score);
+			std::sort(scores.rbegin(),scores.rend());
+			int count = static_cast<int>(std::min<std::size_t>(scores.size(),HistoryIndex::topCount));
+			CHECK(history.getTopCount(level) == count);
+			for (int i = 0; i < count && i < history.getTopCount(level); ++i) CHECK(history.getTop(level,i).score == scores[i]);
+		}
+
+		int recent = static_cast<int>(std::min<std::size_t>(games.size(),HistoryIndex::recentCount));
+		CHECK(history.getRecentCount() == recent);
+		for (int i = 0; i < recent && i < history.getRecentCount(); ++i) {
+			const GameRecord& expected = games[games.size()-1-i],&got = history.getRecent(i);
+			CHECK(got.score == expected.score && got.lines == expected.lines && got.pieces == expected.pieces && got.seed == expected.seed
+			   && got.duration == expected.duration && got.time == expected.time && got.level == expected.level && got.randomizer == expected.randomizer);
+		}
+
+		// a percentile is the lowest score of the range the real one is in
+		std::vector<std::uint32_t> scores;
+		for (const GameRecord& g : games) scores.push_back(g.score);
+		std::sort(scores.begin(),scores.end());
+		for (double percent = 0; percent <= 100 && !scores.empty(); percent += 12.5) {
+			std::size_t wanted = std::min<std::size_t>(static_cast<std::size_t>(percent/100*scores.size()),scores.size()-1);
+			CHECK(history.percentile(percent) == HistoryIndex::lowestOf(HistoryIndex::bucketOf(scores[wanted])));
+		}
+	}
+
+	// every score is in a range whose lowest score is at most it and whose next range starts above it
+	void checkBuckets() {
+		std::mt19937 random(3);
+		for (int i = 0; i < 200000; ++i) {
+			std::uint32_t score = (i < 70000) ? static_cast<std::uint32_t>(i) : static_cast<std::uint32_t>(random()) >> (random()%32);
+			int bucket = HistoryIndex::bucketOf(score);
+			CHECK(bucket >= 0 && bucket < HistoryIndex::buckets);
+			CHECK(HistoryIndex::lowestOf(bucket) <= score);
+			if (bucket+1 < HistoryIndex::buckets) CHECK(HistoryIndex::lowestOf(bucket+1) > score);
+		}
+		CHECK(HistoryIndex::bucketOf(0xffffffffu) == HistoryIndex::buckets-1);
+		// a range is never wider than 1/16 of the scores in it
+		for (int bucket = 16; bucket+1 < HistoryIndex::buckets; ++bucket) {
+			CHECK(HistoryIndex::lowestOf(bucket+1)-HistoryIndex::lowestOf(bucket) <= HistoryIndex::lowestOf(bucket)/16);
+		}
+	}
+
+	void checkLog(const std::string& folder) {
+		std::string log = folder+"history.log",index = folder+"history.idx";
+		std::mt19937 random(11);
+		std::vector<GameRecord> games;
+		{
+			History history;
+			history.open(folder);
+			CHECK(history.isOpen());
+			compare(history,games);
+			for (std::uint32_t n = 0; n < 300; ++n) {
+				games.push_back(game(random,n));
+				CHECK(history.add(games.back()));
+			}
+			compare(history,games);
+		}
+
+		// the next run reads the index as it was left
+		History history;
+		history.open(folder);
+		compare(history,games);
+		history.close();
+
+		// without the index, it is made again from the log
+		std::remove(index.c_str());
+		history.open(folder);
+		compare(history,games);
+
+		// a game that stopped while adding one leaves a cut-off record at the end, which is dropped. The next
+		// game still goes where it should
+		history.close();
+		std::FILE* file = std::fopen(log.c_str(),"ab");
+		if (file != nullptr) { std::fwrite("\x01\x02\x03\x04\x05\x06\x07",1,7,file); std::fclose(file); }
+		history.open(folder);
+		compare(history,games);
+		games.push_back(game(random,300));
+		CHECK(history.add(games.back()));
+		history.close();
+		std::remove(index.c_str());
+		history.open(folder);
+		compare(history,games);
+
+		// a damaged record is left out when the index is made again
+		history.close();
+		file = std::fopen(log.c_str(),"r+b");
+		if (file != nullptr) { std::fseek(file,8+32*5+2,SEEK_SET); std::fputc(0xee,file); std::fclose(file); }
+		std::remove(index.c_str());
+		history.open(folder);
+		games.erase(games.begin()+5);
+		compare(history,games);
+		history.close();
+
+		// a log this version can't read is put aside and a new one started
+		file = std::fopen(log.c_str(),"r+b");
+		if (file != nullptr) { std::fputc('X',file); std::fclose(file); }
+		history.open(folder);
+		compare(history,std::vector<GameRecord>());
+		history.close();
+		std::remove(log.c_str()); std::remove((log+".old").c_str()); std::remove(index.c_str());
+	}
+
+} /* end of anonymous namespace */
+
+int main()
+{
+	checkBuckets();
+	std::string folder = check::folder();
+	checkLog(folder);
+	check::removeFolder(folder);
+	return check::result();
+}
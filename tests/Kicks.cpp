@@ -0,0 +1,146 @@
+// checks the Super Rotation System kicks against the standard as it is usually written down: the shapes as
+// they spawn and the five tests of every turn, in x right and y up. Every test of the table has to put the
+// blocks where the standard puts them, and a turn on a random matrix has to end where the first standard test
+// that fits puts it
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+#include "GameEngine.h"
+#include "Check.h"
+
+namespace
+{
+	using namespace tetris;
+	typedef std::vector<std::pair<int,int>> Cells;
+
+	// the standard shapes as they spawn, on the square grid they turn in, in the order of Type
+	struct Shape {
+		int size;
+		const char* rows[4];
+	};
+	const Shape standard[7] = {
+		{4,{"....","####","....","...."}},  // I (the chord)
+		{2,{"##","##"}},                    // O (the square)
+		{3,{".#.","###","..."}},            // T
+		{3,{"..#","###","..."}},            // L
+		{3,{"#..","###","..."}},            // J (the reversed L)
+		{3,{"##.",".##","..."}},            // Z
+		{3,{".##","##.","..."}}             // S (the reversed Z)
+	};
+	// the standard state the game's Up state is: the game spawns the T, L and J with their flat side up
+	const int upStates[7] = {0,0,2,2,2,0,0};
+
+	// the tests of a turn out of each state, clockwise then anticlockwise: for the J, L, S, T and Z, then for the I
+	const int tests[2][4][2][5][2] = {
+		{{{{0,0},{-1,0},{-1,1},{0,-2},{-1,-2}},{{0,0},{1,0},{1,1},{0,-2},{1,-2}}},      // 0->R, 0->L
+		 {{{0,0},{1,0},{1,-1},{0,2},{1,2}},{{0,0},{1,0},{1,-1},{0,2},{1,2}}},           // R->2, R->0
+		 {{{0,0},{1,0},{1,1},{0,-2},{1,-2}},{{0,0},{-1,0},{-1,1},{0,-2},{-1,-2}}},      // 2->L, 2->R
+		 {{{0,0},{-1,0},{-1,-1},{0,2},{-1,2}},{{0,0},{-1,0},{-1,-1},{0,2},{-1,2}}}},    // L->0, L->2
+		{{{{0,0},{-2,0},{1,0},{-2,-1},{1,2}},{{0,0},{-1,0},{2,0},{-1,2},{2,-1}}},       // 0->R, 0->L
+		 {{{0,0},{-1,0},{2,0},{-1,2},{2,-1}},{{0,0},{2,0},{-1,0},{2,1},{-1,-2}}},       // R->2, R->0
+		 {{{0,0},{2,0},{-1,0},{2,1},{-1,-2}},{{0,0},{1,0},{-2,0},{1,-2},{-2,1}}},       // 2->L, 2->R
+		 {{{0,0},{1,0},{-2,0},{1,-2},{-2,1}},{{0,0},{-2,0},{1,0},{-2,-1},{1,2}}}}       // L->0, L->2
+	};
+
+	// the blocks of a standard shape turned clockwise a number of times, moved by some rows and columns
+	Cells standardCells(const int& type,const int& state,const int& row,const int& column) {
+		const Shape& shape = standard[type];
+		Cells cells;
+		for (int r = 0; r < shape.size; ++r) {
+			for (int c = 0; c < shape.size; ++c) {
+				if (shape.rows[r][c] != '#') continue;
+				int turnedRow = r,turnedColumn = c;
+				for (int n = 0; n < state; ++n) { int was = turnedRow; turnedRow = turnedColumn; turnedColumn = shape.size-1-was; }
+				cells.push_back({turnedRow+row,turnedColumn+column});
+			}
+		}
+		std::sort(cells.begin(),cells.end());
+		return cells;
+	}
+	Cells cellsOf(const Piece& piece) {
+		Cells cells;
+		for (int i = 0; i < 4; ++i) cells.push_back({piece.row(i),piece.column(i)});
+		std::sort(cells.begin(),cells.end());
+		return cells;
+	}
+
+	// where the standard grid of a tetromino is, found from its blocks
+	std::pair<int,int> gridOf(const Piece& piece) {
+		int type = static_cast<int>(piece.type)-1,state = (upStates[type]+static_cast<int>(piece.rotation))%4;
+		Cells game = cellsOf(piece),shape = standardCells(type,state,0,0);
+		return {game[0].first-shape[0].first,game[0].second-shape[0].second};
+	}
+
+	// the blocks of the standard test of a turn, for a tetromino at a place in a state
+	Cells standardTest(const Piece& piece,const bool& clockwise,const int& k) {
+		int type = static_cast<int>(piece.type)-1,state = (upStates[type]+static_cast<int>(piece.rotation))%4;
+		std::pair<int,int> grid = gridOf(piece);
+		int x = (type == 1) ? 0 : tests[type == 0][state][clockwise ? 0 : 1][k][0];
+		int y = (type == 1) ? 0 : tests[type == 0][state][clockwise ? 0 : 1][k][1];
+		return standardCells(type,(state+(clockwise ? 1 : 3))%4,grid.first-y,grid.second+x);
+	}
+
+	// every state of the game is the standard shape of its state, and every test of the table is the standard one
+	void checkTable() {
+		for (int t = 0; t < 7; ++t) {
+			Type type = static_cast<Type>(t+1);
+			for (int s = 0; s < 4; ++s) {
+				Piece piece{type,static_cast<State>(s),4,8};
+				std::pair<int,int> grid = gridOf(piece);
+				CHECK(cellsOf(piece) == standardCells(t,(upStates[t]+s)%4,grid.first,grid.second));
+
+				for (const bool& clockwise : {true,false}) {
+					State to = static_cast<State>((s+(clockwise ? 1 : 3))%4);
+					int count = srsKickTable.count(type,piece.rotation,to);
+					CHECK(count == ((type == Type::Square) ? 1 : 5));
+					const Kick* kicks = srsKickTable.get(type,piece.rotation,to);
+					for (int k = 0; k < count; ++k) {
+						Piece kicked{type,to,static_cast<std::int16_t>(piece.x+kicks[k].column),static_cast<std::int16_t>(piece.y+kicks[k].row)};
+						CHECK(cellsOf(kicked) == standardTest(piece,clockwise,k));
+					}
+				}
+			}
+		}
+	}
+
+	// a turn on a matrix ends where the first standard test that fits puts it, or doesn't happen
+	void checkTurns(const int& rounds) {
+		std::mt19937 random(5);
+		GameEngine engine(1);
+		engine.setKicks(srsKickTable);
+		for (int round = 0; round < rounds; ++round) {
+			Board board;
+			int density = static_cast<int>(random()%60);
+			for (int r = 0; r < Board::height; ++r) {
+				for (int c = 0; c < Board::width; ++c) if (static_cast<int>(random()%100) < density) board.set(r,c,1);
+			}
+			Piece piece{static_cast<Type>(1+random()%7),static_cast<State>(random()%4),
+			            static_cast<std::int16_t>(static_cast<int>(random()%14)-2),static_cast<std::int16_t>(static_cast<int>(random()%22)-1)};
+			if (!fits(board,piece)) continue;
+			engine.setBoard(board);
+
+			Cells expected = cellsOf(piece);
+			int count = (piece.type == Type::Square) ? 1 : 5;
+			for (int k = 0; k < count; ++k) {
+				Cells cells = standardTest(piece,true,k);
+				bool free = true;
+				for (const std::pair<int,int>& cell : cells) {
+					free = free && cell.first >= 0 && cell.first < Board::height && cell.second >= 0 && cell.second < Board::width
+					     && !board.occupied(cell.first,cell.second);
+				}
+				if (free) { expected = cells; break; }
+			}
+			Piece turned = engine.rotated(piece);
+			CHECK(cellsOf(turned) == expected);
+		}
+	}
+
+} /* end of anonymous namespace */
+
+int main()
+{
+	checkTable();
+	checkTurns(200000);
+	return check::result();
+}
@@ -0,0 +1,155 @@
+// checks .trp replays: that a game saved and loaded again has the same header and inputs and plays out the same,
+// that times of every length survive the varints, and that files cut short or damaged are turned down
+#include <random>
+#include <vector>
+#include "Replay.h"
+#include "Check.h"
+
+namespace
+{
+	using namespace tetris;
+
+	std::vector<std::uint8_t> readFile(const std::string& path) {
+		std::vector<std::uint8_t> bytes;
+		std::FILE* file = std::fopen(path.c_str(),"rb");
+		if (file == nullptr) return bytes;
+		std::uint8_t buffer[4096];
+		for (std::size_t n; (n = std::fread(buffer,1,sizeof(buffer),file)) > 0; ) bytes.insert(bytes.end(),buffer,buffer+n);
+		std::fclose(file);
+		return bytes;
+	}
+	void writeFile(const std::string& path,const std::vector<std::uint8_t>& bytes) {
+		std::FILE* file = std::fopen(path.c_str(),"wb");
+		if (file == nullptr) return;
+		std::fwrite(bytes.data(),1,bytes.size(),file);
+		std::fclose(file);
+	}
+
+	// a header for a replay followed by some encoded inputs
+	std::vector<std::uint8_t> withInputs(const std::vector<std::uint8_t>& inputs) {
+		std::vector<std::uint8_t> bytes = {'T','R','P',2,1,0,0,0,0,3,232,3};
+		bytes.insert(bytes.end(),inputs.begin(),inputs.end());
+		return bytes;
+	}
+
+	// times that need every length of varint, from one byte to five
+	void checkTimes(const std::string& path) {
+		const unsigned deltas[] = {0,1,127,128,300,16383,16384,2097151,2097152,268435455,268435456,0x80000000u};
+		Replay replay;
+		replay.start(0xdeadbeefu,Randomizer::Uniform,5,1000);
+		unsigned time = 0;
+		for (const unsigned& delta : deltas) { time += delta; replay.record(time,Input::Left); }
+		CHECK(replay.save(path));
+
+		Replay loaded;
+		CHECK(loaded.load(path));
+		CHECK(loaded.getSeed() == 0xdeadbeefu && loaded.getRandomizer() == Randomizer::Uniform && loaded.getLevel() == 5 && loaded.getDelay() == 1000);
+		CHECK(loaded.getSize() == replay.getSize());
+		Replay::Reader reader(loaded);
+		unsigned milliseconds = 0; Input input = Input::None;
+		time = 0;
+		for (const unsigned& delta : deltas) {
+			time += delta;
+			CHECK(reader.next(milliseconds,input) && milliseconds == time && input == Input::Left);
+		}
+		CHECK(!reader.next(milliseconds,input));
+	}
+
+	// a game recorded as it is played comes back with the same inputs and ends the same when they are applied
+	void checkGame(const std::string& path) {
+		std::mt19937 random(7);
+		GameEngine engine(1234,Randomizer::Bag);
+		Replay replay;
+		replay.start(1234,Randomizer::Bag,3,500);
+		std::vector<Input> played;
+		unsigned time = 0;
+		while (!engine.isOver() && played.size() < 5000) {
+			Input input = static_cast<Input>(1+random()%5);
+			time += random()%700;
+			apply(engine,input); replay.record(time,input); played.push_back(input);
+		}
+		CHECK(replay.save(path));
+
+		Replay loaded;
+		CHECK(loaded.load(path));
+		GameEngine again(loaded.getSeed(),loaded.getRandomizer());
+		Replay::Reader reader(loaded);
+		unsigned milliseconds; Input input;
+		std::size_t count = 0;
+		for (; reader.next(milliseconds,input); ++count) {
+			if (count < played.size()) CHECK(input == played[count]);
+			apply(again,input);
+		}
+		CHECK(count == played.size());
+		CHECK(again.getScore() == engine.getScore() && again.getLines() == engine.getLines() && again.getPieces() == engine.getPieces());
+		CHECK(again.isOver() == engine.isOver());
+		for (int r = 0; r < Board::height; ++r) CHECK(again.getBoard().getRow(r) == engine.getBoard().getRow(r));
+
+		// a replay isn't written over unless it may be
+		CHECK(!replay.save(path,false));
+		CHECK(replay.save(path,true));
+	}
+
+	// a file cut anywhere loads only where an input ends, and then with the inputs before the cut
+	void checkCut(const std::string& path) {
+		Replay replay;
+		replay.start(9,Randomizer::Bag,1,800);
+		replay.record(5,Input::Rotate); replay.record(300,Input::Drop); replay.record(20000,Input::Gravity); replay.record(5000000,Input::Right);
+		CHECK(replay.save(path));
+		std::vector<std::uint8_t> whole = readFile(path);
+		// where the header and every input end: the times take 1, 2, 3 and 4 bytes
+		const std::size_t ends[] = {12,14,17,21,26};
+		CHECK(whole.size() == 26);
+
+		for (std::size_t size = 0; size < whole.size(); ++size) {
+			writeFile(path,std::vector<std::uint8_t>(whole.begin(),whole.begin()+static_cast<long>(size)));
+			bool atEnd = false;
+			for (const std::size_t& end : ends) atEnd = atEnd || end == size;
+			Replay loaded;
+			CHECK(loaded.load(path) == atEnd);
+			CHECK(loaded.getSize() == (atEnd ? size-12 : 0));
+		}
+	}
+
+	// headers and inputs no game writes
+	void checkDamaged(const std::string& path) {
+		Replay loaded;
+		std::vector<std::uint8_t> bytes = withInputs({5,1});
+		writeFile(path,bytes);
+		CHECK(loaded.load(path));
+
+		bytes[0] = 'X'; writeFile(path,bytes);
+		CHECK(!loaded.load(path));
+		bytes = withInputs({5,1}); bytes[3] = 1; writeFile(path,bytes);
+		CHECK(!loaded.load(path));
+		bytes = withInputs({5,1}); bytes[8] = 2; writeFile(path,bytes);
+		CHECK(!loaded.load(path));
+
+		// inputs that don't exist
+		writeFile(path,withInputs({5,0}));
+		CHECK(!loaded.load(path));
+		writeFile(path,withInputs({5,6}));
+		CHECK(!loaded.load(path));
+		// a varint of five bytes is the longest a 32 bit time takes, and one of six is turned down
+		writeFile(path,withInputs({0xff,0xff,0xff,0xff,0x0f,1}));
+		CHECK(loaded.load(path));
+		writeFile(path,withInputs({0x80,0x80,0x80,0x80,0x80,0x00,1}));
+		CHECK(!loaded.load(path));
+		CHECK(loaded.getSize() == 0);
+
+		CHECK(!loaded.load(path+".missing"));
+	}
+
+} /* end of anonymous namespace */
+
+int main()
+{
+	std::string folder = check::folder(),path = folder+"test.trp";
+	checkTimes(path);
+	checkGame(path);
+	checkCut(path);
+	checkDamaged(path);
+	std::remove(path.c_str());
+	check::removeFolder(folder);
+	return check::result();
+}
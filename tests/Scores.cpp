@@ -0,0 +1,124 @@
+// checks the TSCO score record: that scores stored come back, that a record that was damaged or cut short is
+// turned down and started again, and that the text files of older versions are imported into a record
+#include <vector>
+#include "SimpleAssets.h"
+#include "Check.h"
+
+namespace
+{
+	using SimpleAssets::Data;
+
+	std::vector<unsigned char> readFile(const std::string& path) {
+		std::vector<unsigned char> bytes;
+		std::FILE* file = std::fopen(path.c_str(),"rb");
+		if (file == nullptr) return bytes;
+		unsigned char buffer[256];
+		for (std::size_t n; (n = std::fread(buffer,1,sizeof(buffer),file)) > 0; ) bytes.insert(bytes.end(),buffer,buffer+n);
+		std::fclose(file);
+		return bytes;
+	}
+	void writeFile(const std::string& path,const std::vector<unsigned char>& bytes) {
+		std::FILE* file = std::fopen(path.c_str(),"wb");
+		if (file == nullptr) return;
+		std::fwrite(bytes.data(),1,bytes.size(),file);
+		std::fclose(file);
+	}
+
+	// scores read from a folder as the game reads them
+	struct Scores {
+		unsigned highestLines,totalLines,games,highestScore;
+		bool operator==(const Scores& other) const {
+			return highestLines == other.highestLines && totalLines == other.totalLines && games == other.games && highestScore == other.highestScore;
+		}
+	};
+	Scores retrieve(const std::string& folder) {
+		Data data;
+		data.setFolder(folder);
+		data.retrieveGameData();
+		return Scores{data.getHighestLines(),data.getTotalLinesCleared(),data.getGamesPlayed(),data.getHighestScore()};
+	}
+	void store(const std::string& folder,const Scores& scores) {
+		Data data;
+		data.setFolder(folder);
+		data.setHighestLines(scores.highestLines); data.incrementTotalLinesCleared(scores.totalLines);
+		for (unsigned i = 0; i < scores.games; ++i) data.incrementGamesPlayed();
+		data.setHighestScore(scores.highestScore);
+		CHECK(data.createGameData());
+	}
+
+	void checkRecord(const std::string& folder) {
+		std::string file = folder+"tetris.dat";
+		const Scores none = {0,0,0,0},stored = {87,1234,56,0xfedcba98u};
+		store(folder,stored);
+		std::vector<unsigned char> record = readFile(file);
+		CHECK(record.size() == 32);
+		CHECK(record.size() >= 8 && record[0] == 'T' && record[1] == 'S' && record[2] == 'C' && record[3] == 'O');
+		CHECK(retrieve(folder) == stored);
+		// nothing is left from writing the record in place of the old one
+		CHECK(readFile(file+".tmp").empty());
+
+		// a change to any byte fails the checksum, and the scores start from nothing
+		for (std::size_t i = 0; i < record.size(); ++i) {
+			std::vector<unsigned char> damaged = record;
+			damaged[i] ^= 0x10;
+			writeFile(file,damaged);
+			CHECK(retrieve(folder) == none);
+			// which is stored as a record of its own
+			CHECK(readFile(file).size() == 32 && retrieve(folder) == none);
+		}
+
+		// a record cut short is turned down too, down to an empty file
+		writeFile(file,std::vector<unsigned char>(record.begin(),record.begin()+31));
+		CHECK(retrieve(folder) == none);
+		store(folder,stored);
+		CHECK(retrieve(folder) == stored);
+		writeFile(file,std::vector<unsigned char>());
+		CHECK(retrieve(folder) == none);
+
+		// deleting the scores stores the ones it starts from
+		store(folder,stored);
+		Data data;
+		data.setFolder(folder);
+		data.retrieveGameData();
+		data.deleteGameData();
+		CHECK(retrieve(folder) == none);
+	}
+
+	// the file as the versions before the record wrote it
+	void checkImport(const std::string& folder) {
+		std::string file = folder+"tetris.dat";
+		std::FILE* text = std::fopen(file.c_str(),"w");
+		if (text != nullptr) {
+			std::fputs("[Tetris scores]\n",text);
+			std::fputs("Highest lines in one game :   data[ 42 ]\n",text);
+			std::fputs("Total lines cleared :         data[ 900 ]\n",text);
+			std::fputs("Games played :                data[ 31 ]\n",text);
+			std::fputs("Highest score :               data[ 65000 ]",text);
+			std::fclose(text);
+		}
+		const Scores imported = {42,900,31,65000};
+		CHECK(retrieve(folder) == imported);
+		// the scores are a record from then on
+		std::vector<unsigned char> record = readFile(file);
+		CHECK(record.size() == 32 && record[0] == 'T');
+		CHECK(retrieve(folder) == imported);
+
+		// text that isn't the old scores isn't taken in
+		text = std::fopen(file.c_str(),"w");
+		if (text != nullptr) { std::fputs("[Tetris scores]\nHighest lines in one game :   data[ 42 ]\n",text); std::fclose(text); }
+		CHECK(retrieve(folder) == (Scores{0,0,0,0}));
+		Data data;
+		CHECK(!data.importText(folder+"missing.dat"));
+	}
+
+} /* end of anonymous namespace */
+
+int main()
+{
+	std::string folder = check::folder();
+	checkRecord(folder);
+	checkImport(folder);
+	std::remove((folder+"tetris.dat").c_str());
+	check::removeFolder(folder);
+	return check::result();
+}
@@ -0,0 +1,107 @@
+// checks the messages of a versus game: that they survive encoding, that ones no game sends are turned down,
+// that two sides started at the same moment always find each other, and that a side that stops reading is
+// given up on
+#include <chrono>
+#include <csignal>
+#include "Versus.h"
+#include "Check.h"
+#if defined(__linux__)||defined(__linux)||defined(linux)
+#include <sys/wait.h>
+#endif
+
+namespace
+{
+	using namespace tetris;
+	using versus::Kind;
+	using versus::Message;
+
+	void checkMessages() {
+		// every field comes back as it went
+		Message sent{Kind::Garbage,7,3,9,0xdeadbeefu};
+		std::uint8_t bytes[versus::messageSize];
+		versus::encode(sent,bytes);
+		Message got = versus::decode(bytes);
+		CHECK(got.kind == sent.kind && got.input == sent.input && got.count == sent.count && got.hole == sent.hole && got.value == sent.value);
+
+		CHECK(versus::valid(Message{Kind::Hello,versus::version,static_cast<std::uint8_t>(Randomizer::Uniform),0,1}));
+		CHECK(!versus::valid(Message{Kind::Hello,versus::version,2,0,1}));
+		CHECK(versus::valid(Message{Kind::Input,static_cast<std::uint8_t>(Input::Left),0,0,0}));
+		CHECK(versus::valid(Message{Kind::Input,static_cast<std::uint8_t>(Input::Gravity),0,0,0}));
+		CHECK(!versus::valid(Message{Kind::Input,static_cast<std::uint8_t>(Input::None),0,0,0}));
+		CHECK(!versus::valid(Message{Kind::Input,200,0,0,0}));
+		CHECK(versus::valid(Message{Kind::Garbage,0,1,0,0}));
+		CHECK(versus::valid(Message{Kind::Garbage,0,Board::height,Board::width-1,0}));
+		CHECK(!versus::valid(Message{Kind::Garbage,0,0,0,0}));
+		CHECK(!versus::valid(Message{Kind::Garbage,0,Board::height+1,0,0}));
+		CHECK(!versus::valid(Message{Kind::Garbage,0,1,Board::width,0}));
+		CHECK(!versus::valid(Message{Kind::Garbage,0,1,255,0}));
+		CHECK(versus::valid(Message{Kind::Hash,0,0,0,12345}));
+		CHECK(versus::valid(Message{Kind::Over,0,0,0,0}));
+		CHECK(!versus::valid(Message{static_cast<Kind>(0),0,0,0,0}));
+		CHECK(!versus::valid(Message{static_cast<Kind>(6),0,0,0,0}));
+	}
+
+#ifdef TETRIS_VERSUS
+	// starts two sides on the same socket at once, again and again. Each has to end up in a game, one waiting
+	// and the other joining, rather than both waiting on sockets of their own
+	void checkMeeting(const std::string& folder,const int& rounds) {
+		std::string path = folder+"/meet.sock";
+		int stuck = 0;
+		for (int round = 0; round < rounds; ++round) {
+			int gate[2];
+			if (pipe(gate) != 0) { CHECK(false); return; }
+			pid_t sides[2];
+			for (pid_t& side : sides) {
+				if ((side = fork()) == 0) {
+					::close(gate[1]);
+					char go; (void)!read(gate[0],&go,1);
+					alarm(5);
+					versus::Link link;
+					_exit(link.open(path) ? 0 : 1);
+				}
+			}
+			// closing the gate lets both sides go at the same moment
+			::close(gate[0]); ::close(gate[1]);
+			for (pid_t side : sides) {
+				int status = 0;
+				waitpid(side,&status,0);
+				if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) ++stuck;
+			}
+		}
+		CHECK(stuck == 0);
+		unlink((path+".lock").c_str());
+	}
+
+	// a side whose messages are never read is given up on after stallLimit, not waited on forever
+	void checkStall() {
+		int pair[2];
+		if (socketpair(AF_UNIX,SOCK_STREAM,0,pair) != 0) { CHECK(false); return; }
+		versus::Link link;
+		CHECK(link.attach(pair[0]));
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		bool open = true;
+		for (int round = 0; open && round < 100000; ++round) {
+			for (int i = 0; i < 512; ++i) link.send(Message{Kind::Input,static_cast<std::uint8_t>(Input::Left),0,0,0});
+			open = link.flush();
+		}
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+		CHECK(!open && !link.isOpen());
+		CHECK(seconds >= versus::Link::stallLimit/1000.0 && seconds < versus::Link::stallLimit/1000.0+2);
+		::close(pair[1]);
+	}
+#endif
+
+} /* end of anonymous namespace */
+
+int main()
+{
+	checkMessages();
+#ifdef TETRIS_VERSUS
+	char folder[] = "/tmp/tetris-versus-XXXXXX";
+	if (mkdtemp(folder) == nullptr) { std::perror("mkdtemp"); return 1; }
+	checkMeeting(folder,100);
+	rmdir(folder);
+	checkStall();
+#endif
+	return check::result();
+}
@@ -0,0 +1,77 @@
+// measures how fast gravity really runs at every level, against the rows a second each level's delay asks for
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <unistd.h>
+#include "EventLoop.h"
+
+// namespace to contain the harness
+namespace gravity
+{
+	typedef std::chrono::steady_clock Clock;
+
+	// the delay of every level, as setDifficulty() sets it
+	const unsigned delays[6] = {1500,1000,800,500,300,100};
+
+	// how the harness runs, set from the command line
+	struct Options {
+		unsigned rows = 5;      // rows measured at every level and load
+		int level = 0;          // only this level if it isn't 0
+		double load = 0.25;     // the share of every interval spent on the row, as handling and drawing it would
+	};
+
+	bool parse(int argc,char* argv[],Options& options) {
+		for (int i = 1; i+1 < argc; i += 2) {
+			if (std::strcmp(argv[i],"--rows") == 0) options.rows = static_cast<unsigned>(std::strtoul(argv[i+1],nullptr,10));
+			else if (std::strcmp(argv[i],"--level") == 0) options.level = std::atoi(argv[i+1]);
+			else if (std::strcmp(argv[i],"--load") == 0) options.load = std::atof(argv[i+1]);
+			else return false;
+		}
+		return argc%2 == 1 && options.rows > 0 && options.level >= 0 && options.level <= 6 && options.load >= 0;
+	}
+
+	// rows a second gravity runs at with a delay, when every row keeps the game busy for a while
+	double measure(tetris::EventLoop& events,const unsigned& delay,const Clock::duration& busy,const unsigned& rows) {
+		Clock::time_point start = Clock::now(),last = start;
+		events.start(delay);
+		for (unsigned fallen = 0; fallen < rows; ) {
+			if (events.wait() != tetris::Event::Gravity) continue;
+			last = Clock::now(); ++fallen;
+			std::this_thread::sleep_for(busy);
+		}
+		return rows/std::chrono::duration<double>(last-start).count();
+	}
+
+} /* end of namespace gravity */
+
+int main(int argc,char* argv[])
+{
+	using namespace gravity;
+	Options options;
+	if (!parse(argc,argv,options)) {
+		std::fprintf(stderr,"usage: tetris_gravity [--rows n] [--level 1-6] [--load share of the interval]\n");
+		return 1;
+	}
+
+	// keys come from a pipe nothing is written to, so only gravity wakes the loop up
+	int keys[2];
+	if (pipe(keys) != 0) { std::perror("pipe"); return 1; }
+	tetris::EventLoop events;
+	events.open(keys[0]);
+
+	std::printf("%u rows a level, busy for %.0f%% of every interval under load\n\n",options.rows,options.load*100);
+	std::printf("level  delay   wanted rows/s   idle rows/s  error   loaded rows/s  error\n");
+	for (int level = 1; level <= 6; ++level) {
+		if (options.level != 0 && level != options.level) continue;
+		unsigned delay = delays[level-1];
+		double wanted = 1000.0/delay;
+		double idle = measure(events,delay,Clock::duration::zero(),options.rows);
+		double loaded = measure(events,delay,std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double,std::milli>(delay*options.load)),options.rows);
+		std::printf("%5d %5ums %15.3f %13.3f %5.2f%% %15.3f %5.2f%%\n",level,delay,wanted,idle,(idle-wanted)/wanted*100,loaded,(loaded-wanted)/wanted*100);
+		std::fflush(stdout);
+	}
+	events.close();
+	return 0;
+}
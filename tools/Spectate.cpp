@@ -0,0 +1,122 @@
+// watches a game started with --broadcast, drawing it from the records the game sends rather than from its screen
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include "GameView.h"
+#include "EventLoop.h"
+#include "Broadcast.h"
+
+// namespace to contain the spectator
+namespace spectator
+{
+	using namespace tetris;
+
+	// draws what never changes: the borders of the matrix and the labels around it
+	void drawPage(const std::string& path) {
+		renderer.fill(matrixTop-1,matrixLeft,20,'_',blue,Normal);
+		for (int r = matrixTop; r < matrixTop+Board::height; ++r) { renderer.put(r,matrixLeft-1,'|',blue,Normal); renderer.put(r,matrixLeft+20,'|',blue,Normal); }
+		renderer.fill(matrixTop+Board::height,matrixLeft,20,'"',blue,Normal);
+		std::string title = "WATCHING " + path;
+		renderer.text(3,matrixLeft+10-static_cast<int>(title.length())/2,title,yellow,Normal);
+		renderer.text(5,50,"Next:",pink,Normal);
+		renderer.text(matrixTop+Board::height+2,matrixLeft,"# or q leaves",darkgray,Normal);
+	}
+
+	// draws the game as the spectator last saw it
+	void drawPicture(const spectate::Picture& picture) {
+		if (!picture.synced) { renderer.text(12,43,"WAITING FOR A GAME",yellow,Normal); return; }
+		if (picture.current.type != Type::Undefined) drawMatrix(picture.board,picture.current);
+		if (picture.next != Type::Undefined) drawNextShape(picture.next);
+		renderer.fill(12,42,20,' ',normal,Normal);
+		if (picture.over) renderer.text(12,47,"GAME OVER",red,Normal);
+		drawScore(15,"Score: ",picture.score);
+		drawScore(18,"Lines: ",picture.lines);
+		drawScore(21,"Level: ",static_cast<unsigned>(picture.level));
+	}
+
+#ifdef TETRIS_BROADCAST
+	// connects to the game broadcast on a socket. Returns the socket, or -1 if nothing is broadcast there
+	int join(const sockaddr_un& address) {
+		int fd = socket(AF_UNIX,SOCK_STREAM | SOCK_CLOEXEC,0);
+		if (fd >= 0 && connect(fd,reinterpret_cast<const sockaddr*>(&address),sizeof(address)) != 0) { close(fd); fd = -1; }
+		return fd;
+	}
+#endif
+
+	void refresh() {
+		const std::string& cells = renderer.present();
+		if (!cells.empty()) frame << cells << cursor() << color();
+		frame.flush();
+	}
+
+} /* end of namespace spectator */
+
+int main(int argc,char* argv[])
+{
+#ifdef TETRIS_BROADCAST
+	using namespace tetris;
+	if (argc != 2) { std::fprintf(stderr,"usage: %s /path/to/game.sock\n",argv[0]); return 1; }
+
+	sockaddr_un address;
+	std::memset(&address,0,sizeof(address));
+	address.sun_family = AF_UNIX;
+	std::string path = argv[1];
+	if (path.empty() || path.size() >= sizeof(address.sun_path)) { std::fprintf(stderr,"%s is too long for a socket\n",argv[1]); return 1; }
+	std::memcpy(address.sun_path,path.c_str(),path.size());
+	int fd = spectator::join(address);
+	if (fd < 0) { std::fprintf(stderr,"no game is broadcast on %s\n",argv[1]); return 1; }
+
+	EventLoop events;
+	catchStopSignals();
+	events.open();
+	events.watch(fd);
+	frame << "\033[2J\033[?25l"; frame.flush();
+	spectator::drawPage(path);
+
+	spectate::Picture picture;
+	// bytes received that aren't a whole record yet
+	std::uint8_t in[4096];
+	std::size_t received = 0;
+	bool gone = false;
+	while (!gone) {
+		spectator::drawPicture(picture);
+		spectator::refresh();
+
+		Event event = events.wait();
+		if (event == Event::Key) {
+			if (events.getKey() == '#' || events.getKey() == 'q') break;
+			continue;
+		}
+		if (event != Event::Peer) continue;
+		// every record that has arrived is applied before the next frame is drawn. A record that can't be right
+		// means the stream is out of step, so the spectator joins again and starts over from the keyframe it gets
+		bool stepped = false;
+		while (!stepped) {
+			ssize_t n = recv(fd,in+received,sizeof(in)-received,MSG_DONTWAIT);
+			if (n == 0 || (n < 0 && errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK)) { gone = true; break; }
+			if (n < 0) { if (errno == EINTR) continue; break; }
+			received += n;
+			std::size_t whole = received-received%spectate::recordSize;
+			for (std::size_t i = 0; i < whole && !stepped; i += spectate::recordSize) stepped = !picture.apply(spectate::decode(in+i));
+			std::memmove(in,in+whole,received-whole); received -= whole;
+		}
+		if (stepped) {
+			close(fd);
+			fd = spectator::join(address);
+			if (fd < 0) { gone = true; break; }
+			events.watch(fd);
+			received = 0; picture = spectate::Picture();
+		}
+	}
+	events.close();
+	close(fd);
+
+	if (gone) { renderer.fill(12,42,20,' ',normal,Normal); renderer.text(12,46,"GAME CLOSED",red,Normal); spectator::refresh(); }
+	frame << cursor(35,1) << color() << "\033[?25h"; frame.flush();
+	return 0;
+#else
+	(void)argc; (void)argv;
+	std::fprintf(stderr,"watching a game needs Unix domain sockets, which this build doesn't have\n");
+	return 1;
+#endif
+}
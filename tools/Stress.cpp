@@ -0,0 +1,159 @@
+// drops tetrominoes on matrices far bigger than the game's, up to thousands of rows and 64 columns, without a
+// screen, and times what a game does on them: checking that a tetromino fits, working out how far it falls,
+// landing it with the lines it clears and pushing garbage up under the stack. Every matrix is played twice:
+// from empty, and three quarters full of garbage so the stack is far from the bottom and its columns take
+// several words. Fitting, dropping and landing shouldn't cost more as the matrix gets taller, and garbage
+// costs as much as the stack it moves
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include "GameEngine.h"
+
+// namespace to contain the harness
+namespace stress
+{
+	using namespace tetris;
+	typedef std::chrono::steady_clock Clock;
+
+	// how the harness runs, set from the command line
+	struct Options {
+		unsigned pieces = 100000; // tetrominoes dropped on every matrix
+		unsigned seed = 1;        // the seed of the shapes, the same on every matrix
+	};
+
+	bool parse(int argc,char* argv[],Options& options) {
+		for (int i = 1; i+1 < argc; i += 2) {
+			if (std::strcmp(argv[i],"--pieces") == 0) options.pieces = static_cast<unsigned>(std::strtoul(argv[i+1],nullptr,10));
+			else if (std::strcmp(argv[i],"--seed") == 0) options.seed = static_cast<unsigned>(std::strtoul(argv[i+1],nullptr,10));
+			else return false;
+		}
+		return argc%2 == 1 && options.pieces > 0;
+	}
+
+	// what dropping the pieces on a matrix came to
+	struct Result {
+		unsigned long long fits = 0,drops = 0; // calls made while looking for a spot
+		unsigned long long raises = 0;
+		Clock::duration fitting{},dropping{},locking{},raising{};
+		unsigned lines = 0,resets = 0;
+		unsigned long long stack = 0;          // the rows the blocks reached when every tetromino landed, added up
+	};
+
+	// drops every tetromino where it clears the most lines, lands lowest and leaves the fewest holes under it, out
+	// of every rotation and column it fits in from its spawn row. On a deep matrix the bottom three quarters
+	// start as garbage and 2 more rows come up under the stack every 8 tetrominoes. A matrix too full for the
+	// next tetromino is started again
+	template <int Width,int Height>
+	Result play(const Options& options,const bool& deep) {
+		static_assert(Width >= 10,"tetrominoes spawn in the middle of at least 10 columns");
+		typedef BasicBoard<Width,Height> Matrix;
+		std::unique_ptr<Matrix> board(new Matrix());
+		PieceGenerator generator(options.seed,Randomizer::Bag);
+		Xoshiro128 holes(options.seed);
+		Result result;
+		auto restart = [&]() {
+			board->reset();
+			if (deep) board->raise(Height*3/4,static_cast<int>(holes.below(Width)),garbageKind);
+		};
+		restart();
+		// every spot a tetromino fits in, 4 rotations of up to Width+3 columns
+		Piece spots[4*(Width+4)];
+
+		for (unsigned n = 0; n < options.pieces; ++n) {
+			Piece spawn = Piece::spawn(generator.next()).moved(0,(Width-10)/2);
+			if (deep && n%8 == 7) {
+				Clock::time_point start = Clock::now();
+				bool kept = board->raise(2,static_cast<int>(holes.below(Width)),garbageKind);
+				result.raising += Clock::now()-start; ++result.raises;
+				if (!kept) { restart(); ++result.resets; }
+			}
+			if (!fits(*board,spawn)) { restart(); ++result.resets; }
+
+			Clock::time_point start = Clock::now();
+			int count = 0;
+			for (int s = 0; s < 4; ++s) {
+				for (int x = -3; x <= Width; ++x) {
+					// every rotation starts with its top on the spawn row
+					Piece spot{spawn.type,static_cast<State>(s),static_cast<std::int16_t>(x),spawn.y};
+					spot = spot.moved(spawn.top()-spot.top(),0);
+					if (fits(*board,spot)) spots[count++] = spot;
+				}
+			}
+			result.fits += 4*(Width+4);
+			Clock::time_point fitted = Clock::now();
+			for (int i = 0; i < count; ++i) spots[i] = spots[i].moved(dropDistance(*board,spots[i]),0);
+			result.drops += count;
+			Clock::time_point dropped = Clock::now();
+
+			// the most lines first, then lowest, then fewest empty cells right under a block
+			int best = -1,bestScore = 0;
+			for (int i = 0; i < count; ++i) {
+				const Piece& spot = spots[i];
+				int holes = 0,lines = 0;
+				for (int b = 0; b < 4; ++b) {
+					int r = spot.row(b)+1,c = spot.column(b);
+					bool piece = false;
+					for (int k = 0; k < 4; ++k) piece = piece || (spot.row(k) == r && spot.column(k) == c);
+					if (!piece && !board->occupied(r,c)) ++holes;
+				}
+				for (int k = 0; k < spot.orientation().height; ++k) {
+					typename Matrix::Row row = board->getRow(spot.top()+k);
+					for (int b = 0; b < 4; ++b) if (spot.row(b) == spot.top()+k) row |= Matrix::bit(spot.column(b));
+					lines += (row == Matrix::fullRow);
+				}
+				int score = 64*lines+4*spot.top()-16*holes;
+				if (best < 0 || score > bestScore) { best = i; bestScore = score; }
+			}
+			if (best < 0) { restart(); ++result.resets; continue; }
+
+			Clock::time_point landing = Clock::now();
+			place(*board,spots[best]);
+			result.lines += clearLines(*board,spots[best]);
+			Clock::time_point landed = Clock::now();
+
+			result.fitting += fitted-start; result.dropping += dropped-fitted; result.locking += landed-landing;
+			result.stack += Height-board->getSurface();
+		}
+		return result;
+	}
+
+	// prints a line of the table
+	template <int Width,int Height>
+	void report(const Options& options) {
+		auto ns = [](const Clock::duration& time,const unsigned long long& calls) {
+			return calls == 0 ? 0.0 : std::chrono::duration<double,std::nano>(time).count()/calls;
+		};
+		for (bool deep : {false,true}) {
+			Result result = play<Width,Height>(options,deep);
+			std::printf("%4dx%-5d %-5s %9u %8u %7u %9.1f %9.2f %9.2f %9.2f",Width,Height,deep ? "deep" : "empty",options.pieces,result.lines,result.resets,
+			            double(result.stack)/options.pieces,ns(result.fitting,result.fits),ns(result.dropping,result.drops),ns(result.locking,options.pieces));
+			if (deep) std::printf(" %9.2f",ns(result.raising,result.raises));
+			std::printf("\n");
+			std::fflush(stdout);
+		}
+	}
+
+} /* end of namespace stress */
+
+int main(int argc,char* argv[])
+{
+	using namespace stress;
+	Options options;
+	if (!parse(argc,argv,options)) {
+		std::fprintf(stderr,"usage: tetris_stress [--pieces n] [--seed n]\n");
+		return 1;
+	}
+
+	// the game's matrix, then taller and wider ones with rows of every size a row is kept in
+	std::printf("  matrix   start    pieces    lines  resets  stack   fits ns   drop ns   lock ns  raise ns\n");
+	report<10,20>(options);
+	report<10,1024>(options);
+	report<10,4096>(options);
+	report<16,1024>(options);
+	report<32,1024>(options);
+	report<64,1024>(options);
+	report<64,4096>(options);
+	return 0;
+}
@@ -0,0 +1,157 @@
+// tunes the bot's weights by letting a genetic algorithm breed them over thousands of games played on every core
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "Bot.h"
+#include "Scheduler.h"
+
+// namespace to contain the tuner
+namespace tune
+{
+	typedef std::chrono::steady_clock Clock;
+
+	// how the tuner runs, set from the command line
+	struct Options {
+		unsigned generations = 20;
+		unsigned population = 40;
+		unsigned games = 24;       // games every set of weights plays in a generation
+		unsigned pieces = 1000;    // a game stops after this many tetrominoes, so good weights don't play forever
+		unsigned threads = std::thread::hardware_concurrency();
+		unsigned seed = 1;
+	};
+
+	// a set of weights (in the order of Weights) and how many lines it cleared on average
+	struct Candidate {
+		double genes[6];
+		double fitness = 0;
+	};
+
+	// weights are only compared with each other, so every set is scaled to a length of 1
+	void normalize(Candidate& candidate) {
+		double length = 0;
+		for (double gene : candidate.genes) length += gene*gene;
+		length = std::sqrt(length);
+		if (length > 0) for (double& gene : candidate.genes) gene /= length;
+	}
+
+	inline tetris::Weights weightsOf(const Candidate& candidate) {
+		tetris::Weights weights;
+		weights.height = candidate.genes[0]; weights.holes = candidate.genes[1];
+		weights.bumpiness = candidate.genes[2]; weights.lines = candidate.genes[3];
+		weights.wells = candidate.genes[4]; weights.transitions = candidate.genes[5];
+		return weights;
+	}
+
+	// the best of a few candidates picked at random
+	const Candidate& tournament(const std::vector<Candidate>& population,std::mt19937& random) {
+		std::uniform_int_distribution<std::size_t> pick(0,population.size()-1);
+		const Candidate* best = &population[pick(random)];
+		for (int i = 1; i < 3; ++i) {
+			const Candidate& other = population[pick(random)];
+			if (other.fitness > best->fitness) best = &other;
+		}
+		return *best;
+	}
+
+	// a child between two parents, closer to the fitter one, sometimes with one weight nudged
+	Candidate breed(const Candidate& a,const Candidate& b,std::mt19937& random) {
+		Candidate child;
+		double total = a.fitness+b.fitness;
+		double share = (total > 0) ? a.fitness/total : 0.5;
+		for (int g = 0; g < 6; ++g) child.genes[g] = share*a.genes[g]+(1-share)*b.genes[g];
+		if (std::uniform_real_distribution<double>(0,1)(random) < 0.3) {
+			child.genes[std::uniform_int_distribution<int>(0,5)(random)] += std::normal_distribution<double>(0,0.2)(random);
+		}
+		normalize(child);
+		return child;
+	}
+
+	bool parse(int argc,char* argv[],Options& options) {
+		for (int i = 1; i < argc; ++i) {
+			unsigned* value = nullptr;
+			if (std::strcmp(argv[i],"--generations") == 0) value = &options.generations;
+			else if (std::strcmp(argv[i],"--population") == 0) value = &options.population;
+			else if (std::strcmp(argv[i],"--games") == 0) value = &options.games;
+			else if (std::strcmp(argv[i],"--pieces") == 0) value = &options.pieces;
+			else if (std::strcmp(argv[i],"--threads") == 0) value = &options.threads;
+			else if (std::strcmp(argv[i],"--seed") == 0) value = &options.seed;
+			if (value == nullptr || i+1 == argc) return false;
+			*value = static_cast<unsigned>(std::strtoul(argv[++i],nullptr,10));
+		}
+		return options.population >= 2 && options.games >= 1;
+	}
+
+} /* end of namespace tune */
+
+int main(int argc,char* argv[])
+{
+	using namespace tune;
+	Options options;
+	if (!parse(argc,argv,options)) {
+		std::fprintf(stderr,"usage: tetris_tune [--generations n] [--population n] [--games n] [--pieces n] [--threads n] [--seed n]\n");
+		return 1;
+	}
+	tetris::Scheduler scheduler(options.threads);
+	std::printf("tuning on %u threads: %u sets of weights per generation, %u games each, up to %u pieces a game\n",
+	            scheduler.getWorkers(),options.population,options.games,options.pieces);
+
+	// the first generation starts around the bot's default weights
+	std::mt19937 random(options.seed);
+	std::vector<Candidate> population(options.population);
+	for (std::size_t i = 0; i < population.size(); ++i) {
+		tetris::Weights defaults;
+		double genes[6] = {defaults.height,defaults.holes,defaults.bumpiness,defaults.lines,defaults.wells,defaults.transitions};
+		for (int g = 0; g < 6; ++g) population[i].genes[g] = genes[g]+(i == 0 ? 0 : std::normal_distribution<double>(0,0.3)(random));
+		normalize(population[i]);
+	}
+
+	Candidate best = population[0];
+	std::vector<unsigned> lines(options.population*options.games);
+	unsigned long long totalGames = 0;
+	double totalSeconds = 0;
+
+	for (unsigned generation = 1; generation <= options.generations; ++generation) {
+		// every candidate plays the same games this generation, so luck with the shapes is shared out evenly
+		unsigned firstSeed = options.seed*100003u+generation*options.games;
+		Clock::time_point start = Clock::now();
+		scheduler.run(lines.size(),[&](std::size_t task) {
+			tetris::Bot bot(weightsOf(population[task/options.games]));
+			tetris::GameEngine engine(firstSeed+static_cast<unsigned>(task%options.games));
+			bot.play(engine,options.pieces);
+			lines[task] = engine.getLines();
+		});
+		double seconds = std::chrono::duration<double>(Clock::now()-start).count();
+		totalGames += lines.size(); totalSeconds += seconds;
+
+		double mean = 0;
+		for (std::size_t i = 0; i < population.size(); ++i) {
+			unsigned sum = 0;
+			for (unsigned g = 0; g < options.games; ++g) sum += lines[i*options.games+g];
+			population[i].fitness = double(sum)/options.games;
+			mean += population[i].fitness;
+		}
+		mean /= population.size();
+		std::sort(population.begin(),population.end(),[](const Candidate& a,const Candidate& b) { return a.fitness > b.fitness; });
+		if (generation == 1 || population[0].fitness > best.fitness) best = population[0];
+
+		std::printf("generation %3u: best %8.1f lines, mean %8.1f lines, %9.1f games/s\n",generation,population[0].fitness,mean,lines.size()/seconds);
+		std::fflush(stdout);
+
+		// the two best go through unchanged and the rest are bred from the fitter half
+		std::vector<Candidate> children(population.begin(),population.begin()+2);
+		while (children.size() < population.size()) children.push_back(breed(tournament(population,random),tournament(population,random),random));
+		population.swap(children);
+	}
+
+	std::printf("\n%llu games in %.1f s: %.1f games/s on %u threads, %llu tasks stolen\n",
+	            totalGames,totalSeconds,totalGames/totalSeconds,scheduler.getWorkers(),scheduler.getSteals());
+	std::printf("best weights (%.1f lines a game):\n",best.fitness);
+	std::printf("\tdouble height = %f;\n\tdouble holes = %f;\n\tdouble bumpiness = %f;\n\tdouble lines = %f;\n\tdouble wells = %f;\n\tdouble transitions = %f;\n",
+	            best.genes[0],best.genes[1],best.genes[2],best.genes[3],best.genes[4],best.genes[5]);
+	return 0;
+}